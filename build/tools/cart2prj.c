@@ -53,7 +53,7 @@ int main(int argc, char** argv)
 
 				if(project)
 				{
-					unsigned char* out = (unsigned char*)malloc(sizeof(tic_cartridge) * 3);
+					unsigned char* out = (unsigned char*)malloc(tic_project_size(argv[2], cart) + 1);
 
 					if(out)
 					{
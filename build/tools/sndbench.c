@@ -0,0 +1,520 @@
+// MIT License
+
+// Copyright (c) 2020 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Renders every sfx and track of the given carts through the synth without a
+// sound device, prints the synthesis speed per voice type and compares the
+// output with the golden hashes next to this file, e.g.
+//
+//   sndbench -g build/tools/sndbench.golden demos/music.lua demos/sfx.lua
+//
+// the goldens hash the per-voice audio taps, which sound.c computes before
+// blip_buf, so they don't depend on the blip_buf version. A render without a
+// golden fails, -u rewrites the file after an intended change to sound.c.
+// -w <dir> also writes the mixed output of every render as a WAV
+
+#include "api.h"
+#include "core/core.h"
+#include "cart.h"
+#include "tools.h"
+#include "studio/project.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define SAMPLERATE 44100
+#define SFX_RENDER_TICKS (TIC80_FRAMERATE * 2)
+#define TAIL_TICKS (TIC80_FRAMERATE / 2)
+#define MUSIC_MAX_TICKS (TIC80_FRAMERATE * 60 * 5)
+#define WAV_HEADER_SIZE 44
+
+typedef enum
+{
+    VoiceEnvelope,
+    VoiceNoise,
+    VoicePcm,
+    VoiceStream,
+    VoiceMusic,
+    VoiceCount,
+} Voice;
+
+static const char* VoiceNames[] = {"envelope", "noise", "pcm", "stream", "music"};
+
+typedef struct
+{
+    s32 size;
+    u8* data;
+} FileBuffer;
+
+typedef struct
+{
+    s16* data;
+    s32 count;
+    s32 capacity;
+    u64 taps; // hash of the voice taps
+} Samples;
+
+typedef struct
+{
+    char name[64];
+    u64 hash;
+} Golden;
+
+static struct
+{
+    const char* golden;
+    const char* wavs;
+    bool update;
+    s32 failed;
+
+    Golden* items;
+    s32 count;
+    s32 capacity;
+
+    struct
+    {
+        s64 samples;
+        clock_t time;
+    } stats[VoiceCount];
+} bench;
+
+static FileBuffer readFile(const char* path)
+{
+    FileBuffer buffer = {0};
+
+    FILE* file = fopen(path, "rb");
+    if(file)
+    {
+        fseek(file, 0, SEEK_END);
+        buffer.size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        if((buffer.data = malloc(buffer.size)) && fread(buffer.data, buffer.size, 1, file)) {}
+
+        fclose(file);
+    }
+
+    return buffer;
+}
+
+static bool loadCart(const char* path, tic_cartridge* cart)
+{
+    FileBuffer buffer = readFile(path);
+
+    if(!buffer.data)
+        return false;
+
+    const char* ext = strrchr(path, '.');
+    bool done = true;
+
+    if(ext && strcmp(ext, ".tic") == 0)
+        tic_cart_load(cart, buffer.data, buffer.size);
+    else
+        done = tic_project_load(path, (const char*)buffer.data, buffer.size, cart);
+
+    free(buffer.data);
+    return done;
+}
+
+static void writeLE(u8* dst, u32 value, s32 bytes)
+{
+    for(s32 i = 0; i < bytes; i++)
+        dst[i] = value >> (i * BITS_IN_BYTE);
+}
+
+static bool writeWav(const char* path, const Samples* samples)
+{
+    FILE* file = fopen(path, "wb");
+
+    if(!file)
+        return false;
+
+    u32 size = samples->count * sizeof(s16);
+    u8 header[WAV_HEADER_SIZE];
+
+    memcpy(header, "RIFF", 4);          writeLE(header + 4, size + WAV_HEADER_SIZE - 8, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);  writeLE(header + 16, 16, 4);
+    writeLE(header + 20, 1, 2);         writeLE(header + 22, TIC80_SAMPLE_CHANNELS, 2);
+    writeLE(header + 24, SAMPLERATE, 4);
+    writeLE(header + 28, SAMPLERATE * TIC80_SAMPLE_CHANNELS * sizeof(s16), 4);
+    writeLE(header + 32, TIC80_SAMPLE_CHANNELS * sizeof(s16), 2);
+    writeLE(header + 34, 16, 2);
+    memcpy(header + 36, "data", 4);     writeLE(header + 40, size, 4);
+
+    // samples are stored little endian as the synth produces them on every supported target
+    fwrite(header, sizeof header, 1, file);
+    fwrite(samples->data, size, 1, file);
+    fclose(file);
+
+    return true;
+}
+
+#define FNV_BASIS 0xcbf29ce484222325ull
+
+static u64 fnv(u64 hash, const void* data, s32 size)
+{
+    // FNV-1a
+    for(const u8 *ptr = data, *end = ptr + size; ptr != end; ptr++)
+        hash = (hash ^ *ptr) * 0x100000001b3ull;
+
+    return hash;
+}
+
+static Golden* findGolden(const char* name)
+{
+    for(s32 i = 0; i < bench.count; i++)
+        if(strcmp(bench.items[i].name, name) == 0)
+            return &bench.items[i];
+
+    return NULL;
+}
+
+static Golden* addGolden(const char* name)
+{
+    if(bench.count == bench.capacity)
+    {
+        bench.capacity = MAX(bench.capacity * 2, 64);
+        bench.items = realloc(bench.items, bench.capacity * sizeof(Golden));
+    }
+
+    Golden* golden = &bench.items[bench.count++];
+    memset(golden, 0, sizeof *golden);
+    snprintf(golden->name, sizeof golden->name, "%s", name);
+
+    return golden;
+}
+
+// one `name=hash` per line, lines starting with # are comments
+static void loadGoldens(const char* path)
+{
+    FILE* file = fopen(path, "r");
+
+    if(!file)
+        return;
+
+    char line[256];
+    while(fgets(line, sizeof line, file))
+    {
+        char* eq = strchr(line, '=');
+
+        if(line[0] == '#' || !eq)
+            continue;
+
+        *eq = '\0';
+        addGolden(line)->hash = strtoull(eq + 1, NULL, 16);
+    }
+
+    fclose(file);
+}
+
+static bool saveGoldens(const char* path)
+{
+    FILE* file = fopen(path, "w");
+
+    if(!file)
+        return false;
+
+    fprintf(file, "# voice tap hashes written by sndbench -u, see build/tools/sndbench.c\n");
+
+    for(s32 i = 0; i < bench.count; i++)
+        fprintf(file, "%s=%016llx\n", bench.items[i].name, (unsigned long long)bench.items[i].hash);
+
+    fclose(file);
+    return true;
+}
+
+static void checkGolden(const char* name, const Samples* samples)
+{
+    Golden* golden = findGolden(name);
+
+    if(bench.update)
+    {
+        (golden ? golden : addGolden(name))->hash = samples->taps;
+        printf("  %-24s %016llx updated\n", name, (unsigned long long)samples->taps);
+    }
+    else if(!golden)
+    {
+        printf("  %-24s %016llx MISSING\n", name, (unsigned long long)samples->taps);
+        bench.failed++;
+    }
+    else if(golden->hash != samples->taps)
+    {
+        printf("  %-24s %016llx MISMATCH, expected %016llx\n", name,
+            (unsigned long long)samples->taps, (unsigned long long)golden->hash);
+        bench.failed++;
+    }
+    else printf("  %-24s %016llx ok\n", name, (unsigned long long)samples->taps);
+}
+
+static void append(Samples* samples, const s16* data, s32 count)
+{
+    if(samples->count + count > samples->capacity)
+    {
+        samples->capacity = MAX(samples->capacity * 2, samples->count + count);
+        samples->data = realloc(samples->data, samples->capacity * sizeof(s16));
+    }
+
+    memcpy(samples->data + samples->count, data, count * sizeof(s16));
+    samples->count += count;
+}
+
+// only the synthesis itself is timed
+static void synth(tic_mem* tic, Samples* samples, Voice voice)
+{
+    tic_core* core = (tic_core*)tic;
+    s32 points = tic->product.samples.count / TIC80_SAMPLE_CHANNELS;
+
+    clock_t start = clock();
+    tic_core_synth_sound(tic);
+    bench.stats[voice].time += clock() - start;
+    bench.stats[voice].samples += points;
+
+    append(samples, tic->product.samples.buffer, tic->product.samples.count);
+
+    for(s32 ch = 0; ch < TIC_AUDIOTAP_CHANNELS; ch++)
+        for(u32 i = core->audiotap.head - points; i != core->audiotap.head; i++)
+            samples->taps = fnv(samples->taps, &core->audiotap.data[ch][i % TIC_AUDIOTAP_SIZE], sizeof(s16));
+}
+
+static void tick(tic_mem* tic, Samples* samples, Voice voice)
+{
+    tic_core_sound_tick_start(tic);
+    tic_core_sound_tick_end(tic);
+    synth(tic, samples, voice);
+}
+
+static tic_mem* createCore(const tic_cartridge* cart)
+{
+    tic_mem* tic = tic_core_create(SAMPLERATE, TIC80_PIXEL_COLOR_RGBA8888);
+
+    tic->cart = *cart;
+    tic_api_reset(tic);
+    tic->ram->sfx = cart->bank0.sfx;
+    tic->ram->music = cart->bank0.music;
+
+    return tic;
+}
+
+static void finish(const char* cartname, const char* item, Samples* samples)
+{
+    char name[256];
+    snprintf(name, sizeof name, "%s-%s", cartname, item);
+
+    if(bench.golden)
+        checkGolden(name, samples);
+    else
+        printf("  %-24s %016llx\n", name, (unsigned long long)samples->taps);
+
+    if(bench.wavs)
+    {
+        char path[1024];
+        snprintf(path, sizeof path, "%s/%s.wav", bench.wavs, name);
+
+        if(!writeWav(path, samples))
+        {
+            printf("  %-24s cannot write %s\n", name, path);
+            bench.failed++;
+        }
+    }
+
+    samples->count = 0;
+    samples->taps = FNV_BASIS;
+}
+
+static void renderSfx(const tic_cartridge* cart, const char* cartname, Samples* samples)
+{
+    for(s32 i = 0; i < SFX_COUNT; i++)
+    {
+        const tic_sample* effect = &cart->bank0.sfx.samples.data[i];
+
+        if(EMPTY(effect->data))
+            continue;
+
+        const tic_waveform* wave = &cart->bank0.sfx.waveforms.items[effect->data[0].wave];
+        Voice voice = tic_tool_noise(wave) ? VoiceNoise : VoiceEnvelope;
+
+        tic_mem* tic = createCore(cart);
+        tic_api_sfx(tic, i, effect->note, effect->octave, -1, 0, MAX_VOLUME, MAX_VOLUME, effect->speed);
+
+        for(s32 t = 0; t < SFX_RENDER_TICKS; t++)
+            tick(tic, samples, voice);
+
+        tic_api_sfx(tic, -1, 0, 0, -1, 0, MAX_VOLUME, MAX_VOLUME, 0);
+
+        for(s32 t = 0; t < TAIL_TICKS; t++)
+            tick(tic, samples, voice);
+
+        tic_core_close(tic);
+
+        char item[32];
+        snprintf(item, sizeof item, "sfx%02d", i);
+        finish(cartname, item, samples);
+    }
+}
+
+static void renderMusic(const tic_cartridge* cart, const char* cartname, Samples* samples)
+{
+    for(s32 i = 0; i < MUSIC_TRACKS; i++)
+    {
+        if(EMPTY(cart->bank0.music.tracks.data[i].data))
+            continue;
+
+        tic_mem* tic = createCore(cart);
+        tic_api_music(tic, i, -1, -1, false, false, -1, -1);
+
+        for(s32 t = 0; t < MUSIC_MAX_TICKS && tic->ram->music_state.flag.music_status != tic_music_stop; t++)
+            tick(tic, samples, VoiceMusic);
+
+        for(s32 t = 0; t < TAIL_TICKS; t++)
+            tick(tic, samples, VoiceMusic);
+
+        tic_core_close(tic);
+
+        char item[32];
+        snprintf(item, sizeof item, "track%d", i);
+        finish(cartname, item, samples);
+    }
+}
+
+// pcm and stream have no data in the cart, they are fed with generated waves
+static void renderPcm(const tic_cartridge* cart, Samples* samples)
+{
+    tic_mem* tic = createCore(cart);
+
+    for(s32 t = 0; t < SFX_RENDER_TICKS; t++)
+    {
+        tic_core_sound_tick_start(tic);
+
+        for(s32 i = 0; i < TIC_PCM_SIZE; i++)
+            tic->ram->pcm.data[i] = (i * (t % 7 + 1)) ^ t;
+
+        tic_core_sound_tick_end(tic);
+        synth(tic, samples, VoicePcm);
+    }
+
+    tic_core_close(tic);
+    finish("generated", "pcm", samples);
+}
+
+static void renderStream(const tic_cartridge* cart, Samples* samples)
+{
+    tic_mem* tic = createCore(cart);
+
+    for(s32 i = 0; i < TIC_BINARY_SIZE; i++)
+        tic->cart.binary.data[i] = 128 + (s32)(100.0 * sin(i * 0.05) * (i % 4000) / 4000);
+
+    tic->cart.binary.size = TIC_BINARY_SIZE;
+    tic_api_stream(tic, 0, -1, true, 22050, MAX_VOLUME);
+
+    for(s32 t = 0; t < SFX_RENDER_TICKS; t++)
+        tick(tic, samples, VoiceStream);
+
+    tic_core_close(tic);
+    finish("generated", "stream", samples);
+}
+
+s32 main(s32 argc, char** argv)
+{
+    s32 arg = 1;
+
+    for(; arg < argc && argv[arg][0] == '-'; arg++)
+    {
+        if(strcmp(argv[arg], "-u") == 0)
+            bench.update = true;
+        else if(strcmp(argv[arg], "-g") == 0 && arg + 1 < argc)
+            bench.golden = argv[++arg];
+        else if(strcmp(argv[arg], "-w") == 0 && arg + 1 < argc)
+            bench.wavs = argv[++arg];
+        else break;
+    }
+
+    if(arg >= argc)
+    {
+        printf("usage: sndbench [-g <golden file>] [-u] [-w <wav dir>] <cart|project>...\n");
+        return 1;
+    }
+
+    if(bench.golden)
+        loadGoldens(bench.golden);
+
+    tic_cartridge* cart = malloc(sizeof(tic_cartridge));
+    Samples samples = {.taps = FNV_BASIS};
+
+    for(; arg < argc; arg++)
+    {
+        memset(cart, 0, sizeof(tic_cartridge));
+
+        if(!loadCart(argv[arg], cart))
+        {
+            printf("cannot load %s\n", argv[arg]);
+            bench.failed++;
+            continue;
+        }
+
+        // golden names are the file name without folders and extension
+        char cartname[128];
+        const char* base = argv[arg];
+        for(const char* c = base; *c; c++)
+            if(*c == '/' || *c == '\\')
+                base = c + 1;
+
+        snprintf(cartname, sizeof cartname, "%s", base);
+        char* ext = strrchr(cartname, '.');
+        if(ext) *ext = '\0';
+
+        printf("%s\n", argv[arg]);
+        renderSfx(cart, cartname, &samples);
+        renderMusic(cart, cartname, &samples);
+    }
+
+    memset(cart, 0, sizeof(tic_cartridge));
+    printf("generated\n");
+    renderPcm(cart, &samples);
+    renderStream(cart, &samples);
+
+    printf("\n%-10s %12s %10s %14s\n", "voice", "samples", "ms", "samples/sec");
+    for(s32 i = 0; i < VoiceCount; i++)
+    {
+        double seconds = (double)bench.stats[i].time / CLOCKS_PER_SEC;
+
+        if(bench.stats[i].samples)
+            printf("%-10s %12lld %10.1f %14.0f\n", VoiceNames[i], (long long)bench.stats[i].samples,
+                seconds * 1000, seconds > 0 ? bench.stats[i].samples / seconds : 0);
+    }
+
+    if(bench.golden && bench.update && !saveGoldens(bench.golden))
+    {
+        printf("\ncannot write %s\n", bench.golden);
+        bench.failed++;
+    }
+
+    free(samples.data);
+    free(cart);
+    free(bench.items);
+
+    if(bench.failed)
+        printf("\n%d failed\n", bench.failed);
+
+    return bench.failed ? 1 : 0;
+}
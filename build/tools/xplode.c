@@ -111,7 +111,8 @@ s32 main(s32 argc, char** argv)
 
             // save project
             {
-                FileBuffer buffer = {sizeof(tic_cartridge) * 3, malloc(buffer.size)};
+                s32 size = tic_project_size("project.lua", cart) + 1;
+                FileBuffer buffer = {size, malloc(size)};
                 buffer.size = tic_project_save("project.lua", buffer.data, cart);
 
                 writeFile("project.lua", buffer);
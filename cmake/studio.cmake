@@ -11,6 +11,7 @@ set(TIC80STUDIO_SRC
     ${TIC80LIB_DIR}/studio/studio.c
     ${TIC80LIB_DIR}/studio/config.c
     ${TIC80LIB_DIR}/studio/fs.c
+    ${TIC80LIB_DIR}/studio/thread.c
     ${TIC80LIB_DIR}/ext/md5.c
     ${TIC80LIB_DIR}/ext/json.c
     ${TIC80LIB_DIR}/ext/png.c
@@ -20,6 +21,7 @@ if(BUILD_EDITORS)
     set(TIC80STUDIO_SRC ${TIC80STUDIO_SRC}
         ${TIC80LIB_DIR}/studio/screens/console.c
         ${TIC80LIB_DIR}/studio/screens/surf.c
+        ${TIC80LIB_DIR}/studio/cartindex.c
         ${TIC80LIB_DIR}/studio/editors/code.c
         ${TIC80LIB_DIR}/studio/editors/sprite.c
         ${TIC80LIB_DIR}/studio/editors/map.c
@@ -27,12 +29,16 @@ if(BUILD_EDITORS)
         ${TIC80LIB_DIR}/studio/editors/sfx.c
         ${TIC80LIB_DIR}/studio/editors/music.c
         ${TIC80LIB_DIR}/studio/net.c
+        ${TIC80LIB_DIR}/studio/render.c
+        ${TIC80LIB_DIR}/studio/recorder.c
+        ${TIC80LIB_DIR}/studio/capture.c
         ${TIC80LIB_DIR}/ticbuild_remoting/fps.c
         ${TIC80LIB_DIR}/ticbuild_remoting/user_timing.c
         ${TIC80LIB_DIR}/ticbuild_remoting/remoting.c
         ${TIC80LIB_DIR}/ticbuild_remoting/discovery.c
         ${TIC80LIB_DIR}/ticbuild_remoting/lua_eval.c
         ${TIC80LIB_DIR}/ticbuild_remoting/lua_serialize.c
+        ${TIC80LIB_DIR}/ticbuild_remoting/carthash.c
         ${TIC80LIB_DIR}/ext/history.c
         ${TIC80LIB_DIR}/ext/gif.c
     )
@@ -60,6 +66,13 @@ if(BUILD_WITH_LUA OR BUILD_WITH_MOON OR BUILD_WITH_YUE OR BUILD_WITH_FENNEL)
     target_link_libraries(tic80studio PRIVATE luaapi)
 endif()
 
+if(BUILD_EDITORS AND NOT EMSCRIPTEN)
+    find_package(Threads)
+    if(Threads_FOUND)
+        target_link_libraries(tic80studio PRIVATE Threads::Threads)
+    endif()
+endif()
+
 if(USE_NAETT)
     target_compile_definitions(tic80studio PRIVATE USE_NAETT)
     target_link_libraries(tic80studio PRIVATE naett)
@@ -1,5 +1,5 @@
 ################################
-# bin2txt cart2prj prj2cart xplode wasmp2cart
+# bin2txt cart2prj prj2cart xplode wasmp2cart sndbench
 ################################
 
 if(BUILD_TOOLS)
@@ -33,4 +33,12 @@ if(BUILD_TOOLS)
         target_link_libraries(xplode m)
     endif()
 
+    add_executable(sndbench ${TOOLS_DIR}/sndbench.c ${CMAKE_SOURCE_DIR}/src/studio/project.c)
+    target_include_directories(sndbench PRIVATE ${CMAKE_SOURCE_DIR}/src ${CMAKE_SOURCE_DIR}/include)
+    target_link_libraries(sndbench tic80core)
+
+    if(LINUX)
+        target_link_libraries(sndbench m)
+    endif()
+
 endif()
\ No newline at end of file
@@ -47,6 +47,10 @@ extern "C" {
 #define TIC80_SAMPLESIZE        sizeof(TIC80_SAMPLETYPE)
 #define TIC80_SAMPLE_CHANNELS   2
 #define TIC80_FRAMERATE         60
+#define TIC80_DIRTY_ROWS_WORDS  ((TIC80_FULLHEIGHT + 31) / 32)
+
+#define TIC80_ROW_DIRTY(PRODUCT, ROW)       ((PRODUCT)->dirty.rows[(ROW) >> 5] & (1u << ((ROW) & 31)))
+#define TIC80_SET_ROW_DIRTY(PRODUCT, ROW)   ((PRODUCT)->dirty.rows[(ROW) >> 5] |= 1u << ((ROW) & 31))
 
 typedef enum {
     TIC80_PIXEL_COLOR_ARGB8888 = (1 << 8) | 32,
@@ -71,6 +75,12 @@ typedef struct
     } samples;
 
     u32 *screen;
+
+    // rows of `screen` changed by the last blit, one bit per row
+    struct
+    {
+        u32 rows[TIC80_DIRTY_ROWS_WORDS];
+    } dirty;
 } tic80;
 
 typedef union
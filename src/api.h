@@ -822,7 +822,40 @@ enum
         1,                                                                                                              \
         0,                                                                                                              \
         double,                                                                                                         \
-        tic_mem*, s32 startFreq, s32 endFreq)
+        tic_mem*, s32 startFreq, s32 endFreq)                                                                           \
+                                                                                                                        \
+                                                                                                                        \
+    macro(stream,                                                                                                       \
+        "stream(offset length=-1 loop=false rate=8000 volume=15)",                                                      \
+                                                                                                                        \
+        "Plays sound straight from the cart binary section on a separate voice, "                                       \
+        "so long samples don't have to be poked into PCM memory every frame.\n"                                         \
+        "The data is read as unsigned 8-bit mono samples, the same format as 8-bit WAV files.\n"                        \
+        "`offset` is the byte position in the binary section, a negative value stops the stream.\n"                     \
+        "`length` is the number of samples to play, -1 plays to the end of the binary data.\n"                          \
+        "If `loop` is true, playback restarts from `offset` when it reaches the end.\n"                                 \
+        "The `rate` is the playback rate in Hz between 1 and 96000.\n"                                                  \
+        "The `volume` can be between 0 and 15.\n"                                                                       \
+        "Every call restarts the stream from the beginning.",                                                           \
+        5,                                                                                                              \
+        1,                                                                                                              \
+        0,                                                                                                              \
+        void,                                                                                                           \
+        tic_mem*, s32 offset, s32 length, bool loop, s32 rate, s32 volume)                                              \
+                                                                                                                        \
+                                                                                                                        \
+    macro(audiotap,                                                                                                     \
+        "audiotap(channel index=0)",                                                                                    \
+                                                                                                                        \
+        "Returns a sample of the output of a single voice before it is mixed, between -1 and 1.\n"                      \
+        "Channels 0..3 are the sound channels, 4 is the PCM voice and 5 is the stream() voice.\n"                       \
+        "`index` counts output samples back from the newest one, up to 2047, "                                          \
+        "so drawing an oscilloscope takes one call per point.",                                                         \
+        2,                                                                                                              \
+        1,                                                                                                              \
+        0,                                                                                                              \
+        double,                                                                                                         \
+        tic_mem*, s32 channel, s32 index)
 
 #define TIC_API_DEF(name, _, __, ___, ____, _____, ret, ...) ret tic_api_##name(__VA_ARGS__);
 TIC_API_LIST(TIC_API_DEF)
@@ -860,6 +893,13 @@ struct tic_mem
 };
 
 tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format);
+void tic_core_samplerate(tic_mem* memory, s32 samplerate);
+void tic_core_sound_target(tic_mem* memory, s32 ticks);
+void tic_core_sound_burst(tic_mem* memory, s32 ticks);
+void tic_core_sound_flush(tic_mem* memory);
+s32 tic_core_sound_latency(tic_mem* memory);
+s32 tic_core_music_seek(tic_mem* memory, s32 index, s32 frame, s32 row, bool loop, bool sustain, s32 tempo, s32 speed);
+s32 tic_core_audiotap(tic_mem* memory, s32 channel, s32 offset, s16* out, s32 count);
 void tic_core_close(tic_mem* memory);
 void tic_core_pause(tic_mem* memory);
 void tic_core_resume(tic_mem* memory);
@@ -869,6 +909,8 @@ void tic_core_tick_end(tic_mem* memory);
 void tic_core_synth_sound(tic_mem* tic);
 void tic_core_blit(tic_mem* tic);
 void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb);
+void tic_core_invalidate_rows(tic_mem* tic, s32 row, s32 count);
+bool tic_core_pmem_dirty(tic_mem* memory);
 
 #define VBANK(tic, bank)                                \
     bool MACROVAR(_bank_) = tic_api_vbank(tic, bank);   \
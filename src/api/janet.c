@@ -81,6 +81,8 @@ static Janet janet_fget(int32_t argc, Janet* argv);
 static Janet janet_fset(int32_t argc, Janet* argv);
 static Janet janet_fft(int32_t argc, Janet* argv);
 static Janet janet_ffts(int32_t argc, Janet* argv);
+static Janet janet_stream(int32_t argc, Janet* argv);
+static Janet janet_audiotap(int32_t argc, Janet* argv);
 
 static void closeJanet(tic_mem* tic);
 static bool initJanet(tic_mem* tic, const char* code);
@@ -146,6 +148,8 @@ static const JanetReg janet_c_functions[] =
     {"fset", janet_fset, NULL},
     {"fft", janet_fft, NULL},
     {"ffts", janet_ffts, NULL},
+    {"stream", janet_stream, NULL},
+    {"audiotap", janet_audiotap, NULL},
     {NULL, NULL, NULL}
 };
 
@@ -1084,6 +1088,32 @@ static Janet janet_ffts(int32_t argc, Janet* argv)
     return janet_wrap_number(core->api.fft(tic, start_freq, end_freq));
 }
 
+static Janet janet_stream(int32_t argc, Janet* argv)
+{
+    janet_arity(argc, 1, 5);
+
+    s32 offset = janet_getinteger(argv, 0);
+    s32 length = (s32)janet_optinteger(argv, argc, 1, -1);
+    bool loop = janet_optboolean(argv, argc, 2, false);
+    s32 rate = (s32)janet_optinteger(argv, argc, 3, TIC_STREAM_RATE);
+    s32 volume = (s32)janet_optinteger(argv, argc, 4, MAX_VOLUME);
+
+    tic_core* core = getJanetMachine(); tic_mem* tic = (tic_mem*)core;
+    core->api.stream(tic, offset, length, loop, rate, volume);
+    return janet_wrap_nil();
+}
+
+static Janet janet_audiotap(int32_t argc, Janet* argv)
+{
+    janet_arity(argc, 1, 2);
+
+    s32 channel = janet_getinteger(argv, 0);
+    s32 index = (s32)janet_optinteger(argv, argc, 1, 0);
+
+    tic_core* core = getJanetMachine(); tic_mem* tic = (tic_mem*)core;
+    return janet_wrap_number(core->api.audiotap(tic, channel, index));
+}
+
 /* ***************** */
 static void reportError(tic_core* core, Janet result)
 {
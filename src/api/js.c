@@ -1032,6 +1032,29 @@ static JSValue js_ffts(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueC
     return JS_NewFloat64(ctx, core->api.ffts(tic, start_freq, end_freq));
 }
 
+static JSValue js_stream(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
+{
+    tic_core* core = getCore(ctx); tic_mem* tic = (tic_mem*)core;
+    s32 offset = getInteger(ctx, argv[0]);
+    s32 length = getInteger2(ctx, argv[1], -1);
+    bool loop = JS_ToBool(ctx, argv[2]);
+    s32 rate = getInteger2(ctx, argv[3], TIC_STREAM_RATE);
+    s32 volume = getInteger2(ctx, argv[4], MAX_VOLUME);
+
+    core->api.stream(tic, offset, length, loop, rate, volume);
+
+    return JS_UNDEFINED;
+}
+
+static JSValue js_audiotap(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
+{
+    tic_core* core = getCore(ctx); tic_mem* tic = (tic_mem*)core;
+    s32 channel = getInteger(ctx, argv[0]);
+    s32 index = getInteger2(ctx, argv[1], 0);
+
+    return JS_NewFloat64(ctx, core->api.audiotap(tic, channel, index));
+}
+
 static bool initJavascript(tic_mem* tic, const char* code)
 {
     closeJavascript(tic);
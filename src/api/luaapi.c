@@ -1595,6 +1595,49 @@ static s32 lua_ffts(lua_State* lua)
     return 0;
 }
 
+static s32 lua_stream(lua_State* lua)
+{
+    tic_core* core = getLuaCore(lua);
+
+    tic_mem* tic = (tic_mem*)getLuaCore(lua);
+    s32 top = lua_gettop(lua);
+
+    if (top >= 1)
+    {
+        s32 offset = getLuaNumber(lua, 1);
+        s32 length = top >= 2 ? getLuaNumber(lua, 2) : -1;
+        bool loop = top >= 3 ? lua_toboolean(lua, 3) : false;
+        s32 rate = top >= 4 ? getLuaNumber(lua, 4) : TIC_STREAM_RATE;
+        s32 volume = top >= 5 ? getLuaNumber(lua, 5) : MAX_VOLUME;
+
+        core->api.stream(tic, offset, length, loop, rate, volume);
+        return 0;
+    }
+
+    luaL_error(lua, "invalid params, stream(offset, length=-1, loop=false, rate=8000, volume=15)\n");
+    return 0;
+}
+
+static s32 lua_audiotap(lua_State* lua)
+{
+    tic_core* core = getLuaCore(lua);
+
+    tic_mem* tic = (tic_mem*)getLuaCore(lua);
+    s32 top = lua_gettop(lua);
+
+    if (top >= 1)
+    {
+        s32 channel = getLuaNumber(lua, 1);
+        s32 index = top >= 2 ? getLuaNumber(lua, 2) : 0;
+
+        lua_pushnumber(lua, core->api.audiotap(tic, channel, index));
+        return 1;
+    }
+
+    luaL_error(lua, "invalid params, audiotap(channel, index=0)\n");
+    return 0;
+}
+
 static int lua_dofile(lua_State *lua)
 {
     luaL_error(lua, "unknown method: \"dofile\"\n");
@@ -568,6 +568,29 @@ static mrb_value mrb_ffts(mrb_state* mrb, mrb_value self)
     }
 }
 
+static mrb_value mrb_stream(mrb_state* mrb, mrb_value self)
+{
+    mrb_int offset, length = -1, rate = TIC_STREAM_RATE, volume = MAX_VOLUME;
+    mrb_bool loop = false;
+    mrb_get_args(mrb, "i|ibii", &offset, &length, &loop, &rate, &volume);
+
+    tic_core* core = getMRubyMachine(mrb); tic_mem* tic = (tic_mem*)core;
+
+    core->api.stream(tic, offset, length, loop, rate, volume);
+
+    return mrb_nil_value();
+}
+
+static mrb_value mrb_audiotap(mrb_state* mrb, mrb_value self)
+{
+    mrb_int channel, index = 0;
+    mrb_get_args(mrb, "i|i", &channel, &index);
+
+    tic_core* core = getMRubyMachine(mrb); tic_mem* tic = (tic_mem*)core;
+
+    return mrb_float_value(mrb, core->api.audiotap(tic, channel, index));
+}
+
 typedef struct
 {
     mrb_state* mrb;
@@ -772,6 +772,34 @@ s7_pointer scheme_ffts(s7_scheme* sc, s7_pointer args)
     return s7_make_real(sc, core->api.ffts(tic, start_freq, end_freq));
 }
 
+s7_pointer scheme_stream(s7_scheme* sc, s7_pointer args)
+{
+    // stream(int offset, int length=-1, bool loop=false, int rate=8000, int volume=15)
+    tic_core* core = getSchemeCore(sc);
+    tic_mem* tic = (tic_mem*)core;
+    const int argn = s7_list_length(sc, args);
+    const s32 offset = s7_integer(s7_car(args));
+    const s32 length = argn > 1 ? s7_integer(s7_cadr(args)) : -1;
+    const bool loop = argn > 2 ? s7_boolean(sc, s7_caddr(args)) : false;
+    const s32 rate = argn > 3 ? s7_integer(s7_cadddr(args)) : TIC_STREAM_RATE;
+    const s32 volume = argn > 4 ? s7_integer(s7_list_ref(sc, args, 4)) : MAX_VOLUME;
+
+    core->api.stream(tic, offset, length, loop, rate, volume);
+    return s7_nil(sc);
+}
+
+s7_pointer scheme_audiotap(s7_scheme* sc, s7_pointer args)
+{
+    // audiotap(int channel, int index=0) -> float_value
+    tic_core* core = getSchemeCore(sc);
+    tic_mem* tic = (tic_mem*)core;
+    const int argn = s7_list_length(sc, args);
+    const s32 channel = s7_integer(s7_car(args));
+    const s32 index = argn > 1 ? s7_integer(s7_cadr(args)) : 0;
+
+    return s7_make_real(sc, core->api.audiotap(tic, channel, index));
+}
+
 static void initAPI(tic_core* core)
 {
     s7_scheme* sc = core->currentVM;
@@ -1581,6 +1581,54 @@ static SQInteger squirrel_ffts(HSQUIRRELVM vm)
     return 0;
 }
 
+static SQInteger squirrel_stream(HSQUIRRELVM vm)
+{
+    tic_core* core = getSquirrelCore(vm);
+    tic_mem* tic = (tic_mem*)core;
+
+    SQInteger top = sq_gettop(vm);
+
+    if (top >= 2)
+    {
+        s32 offset = getSquirrelNumber(vm, 2);
+        s32 length = top >= 3 ? getSquirrelNumber(vm, 3) : -1;
+        s32 rate = top >= 5 ? getSquirrelNumber(vm, 5) : TIC_STREAM_RATE;
+        s32 volume = top >= 6 ? getSquirrelNumber(vm, 6) : MAX_VOLUME;
+
+        SQBool loop = SQFalse;
+        if (top >= 4)
+            sq_getbool(vm, 4, &loop);
+
+        core->api.stream(tic, offset, length, loop, rate, volume);
+        return 0;
+    }
+
+    sq_throwerror(vm, "invalid params, stream(offset, length, loop, rate, volume)\n");
+
+    return 0;
+}
+
+static SQInteger squirrel_audiotap(HSQUIRRELVM vm)
+{
+    tic_core* core = getSquirrelCore(vm);
+    tic_mem* tic = (tic_mem*)core;
+
+    SQInteger top = sq_gettop(vm);
+
+    if (top >= 2)
+    {
+        s32 channel = getSquirrelNumber(vm, 2);
+        s32 index = top >= 3 ? getSquirrelNumber(vm, 3) : 0;
+
+        sq_pushfloat(vm, (SQFloat)(core->api.audiotap(tic, channel, index)));
+        return 1;
+    }
+
+    sq_throwerror(vm, "invalid params, audiotap(channel, index)\n");
+
+    return 0;
+}
+
 static SQInteger squirrel_dofile(HSQUIRRELVM vm)
 {
     return sq_throwerror(vm, "unknown method: \"dofile\"\n");
@@ -148,6 +148,13 @@ class TIC {\n\
     foreign static exit()\n\
     foreign static fft(start_freq, end_freq)\n\
     foreign static ffts(start_freq, end_freq)\n\
+    foreign static stream(offset)\n\
+    foreign static stream(offset, length)\n\
+    foreign static stream(offset, length, loop)\n\
+    foreign static stream(offset, length, loop, rate)\n\
+    foreign static stream(offset, length, loop, rate, volume)\n\
+    foreign static audiotap(channel)\n\
+    foreign static audiotap(channel, index)\n\
     foreign static map_width__\n\
     foreign static map_height__\n\
     foreign static spritesize__\n\
@@ -1507,6 +1514,45 @@ static void wren_ffts(WrenVM* vm)
     wrenError(vm, "invalid params, ffts(start_freq, end_freq)\n");
 }
 
+static void wren_stream(WrenVM* vm)
+{
+    tic_core* core = getWrenCore(vm);
+    tic_mem* tic = (tic_mem*)core;
+    s32 top = wrenGetSlotCount(vm);
+
+    if (top > 1)
+    {
+        s32 offset = getWrenNumber(vm, 1);
+        s32 length = top > 2 ? getWrenNumber(vm, 2) : -1;
+        bool loop = top > 3 ? wrenGetSlotBool(vm, 3) : false;
+        s32 rate = top > 4 ? getWrenNumber(vm, 4) : TIC_STREAM_RATE;
+        s32 volume = top > 5 ? getWrenNumber(vm, 5) : MAX_VOLUME;
+
+        core->api.stream(tic, offset, length, loop, rate, volume);
+        return;
+    }
+
+    wrenError(vm, "invalid params, stream(offset, length, loop, rate, volume)\n");
+}
+
+static void wren_audiotap(WrenVM* vm)
+{
+    tic_core* core = getWrenCore(vm);
+    tic_mem* tic = (tic_mem*)core;
+    s32 top = wrenGetSlotCount(vm);
+
+    if (top > 1)
+    {
+        s32 channel = getWrenNumber(vm, 1);
+        s32 index = top > 2 ? getWrenNumber(vm, 2) : 0;
+
+        wrenSetSlotDouble(vm, 0, core->api.audiotap(tic, channel, index));
+        return;
+    }
+
+    wrenError(vm, "invalid params, audiotap(channel, index)\n");
+}
+
 static WrenForeignMethodFn foreignTicMethods(const char* signature)
 {
     if (strcmp(signature, "static TIC.btn()"                    ) == 0) return wren_btn;
@@ -1620,6 +1666,13 @@ static WrenForeignMethodFn foreignTicMethods(const char* signature)
 
     if (strcmp(signature, "static TIC.fft(_,_)"                 ) == 0) return wren_fft;
     if (strcmp(signature, "static TIC.ffts(_,_)"                ) == 0) return wren_ffts;
+    if (strcmp(signature, "static TIC.stream(_)"                ) == 0) return wren_stream;
+    if (strcmp(signature, "static TIC.stream(_,_)"              ) == 0) return wren_stream;
+    if (strcmp(signature, "static TIC.stream(_,_,_)"            ) == 0) return wren_stream;
+    if (strcmp(signature, "static TIC.stream(_,_,_,_)"          ) == 0) return wren_stream;
+    if (strcmp(signature, "static TIC.stream(_,_,_,_,_)"        ) == 0) return wren_stream;
+    if (strcmp(signature, "static TIC.audiotap(_)"              ) == 0) return wren_audiotap;
+    if (strcmp(signature, "static TIC.audiotap(_,_)"            ) == 0) return wren_audiotap;
 
     // internal functions
     if (strcmp(signature, "static TIC.map_width__"              ) == 0) return wren_map_width;
@@ -57,6 +57,7 @@ typedef enum
     CHUNK_SCREEN,       // 18
     CHUNK_BINARY,       // 19
     CHUNK_LANG,         // 20
+    CHUNK_ZIP,          // 21 - zipped chunk, the first byte is the type of the packed chunk
 } ChunkType;
 
 typedef struct
@@ -118,167 +119,318 @@ tic_cartridge* loadPngCart(png_buffer buffer)
     return NULL;
 }
 
-void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
+typedef struct
 {
-    memset(cart, 0, sizeof(tic_cartridge));
-    const u8* end = buffer + size;
-    u8 *chunk_cart = NULL;
+    ChunkType type;
+    s32 bank;
+    s32 size;
+    const u8* data;
+    bool zip;
+} CartChunk;
+
+struct tic_cart_view
+{
+    u8* png;
+    CartChunk* chunks;
+    s32 count;
+};
+
+static void closeView(tic_cart_view* view)
+{
+    free(view->png);
+    free(view->chunks);
+}
+
+static bool openView(tic_cart_view* view, const u8* buffer, s32 size)
+{
+    *view = (tic_cart_view){0};
 
     // check if this cartridge is in PNG format
-    if (!memcmp(buffer, "\x89PNG", 4))
+    if (size >= 4 && !memcmp(buffer, "\x89PNG", 4))
     {
         png_buffer buf = getRawCartFromPng((png_buffer){.data = (u8*)buffer, .size = size});
 
-        if(buf.data)
-        {
-            chunk_cart = buf.data;
-            buffer = buf.data;
-            size = buf.size;
-            end = buffer + size;
-        }
-        else
-            return;
+        if(!buf.data)
+            return false;
+
+        view->png = buf.data;
+        buffer = buf.data;
+        size = buf.size;
     }
 
-#define LOAD_CHUNK(to) memcpy(&to, ptr, MIN(sizeof(to), chunk->size ? retro_le_to_cpu16(chunk->size) : TIC_BANK_SIZE))
+    s32 capacity = 0;
+    const u8* ptr = buffer;
+    const u8* end = buffer + size;
 
-    // load palette chunk first
+    while(end - ptr >= (s32)sizeof(Chunk))
     {
-        const u8* ptr = buffer;
-        while (ptr < end)
+        // chunks are packed without alignment
+        Chunk chunk;
+        memcpy(&chunk, ptr, sizeof(Chunk));
+        ptr += sizeof(Chunk);
+
+        if(view->count == capacity)
         {
-            const Chunk* chunk = (Chunk*)ptr;
-            ptr += sizeof(Chunk);
+            capacity = capacity ? capacity * 2 : 64;
+            CartChunk* chunks = realloc(view->chunks, capacity * sizeof(CartChunk));
 
-            switch (chunk->type)
+            if(!chunks)
             {
-            case CHUNK_PALETTE:
-                LOAD_CHUNK(cart->banks[chunk->bank].palette);
-                break;
-            case CHUNK_DEFAULT:
-                memcpy(&cart->banks[chunk->bank].palette, Sweetie16, sizeof Sweetie16);
-                memcpy(&cart->banks[chunk->bank].sfx.waveforms, Waveforms, sizeof Waveforms);
-                break;
-            default: break;
+                closeView(view);
+                return false;
             }
 
-            ptr += chunkSize(chunk);
+            view->chunks = chunks;
         }
 
+        s32 length = MIN(chunkSize(&chunk), (s32)(end - ptr));
+
+        view->chunks[view->count++] = chunk.type == CHUNK_ZIP && length > 0
+            ? (CartChunk){ptr[0], chunk.bank, length - 1, ptr + 1, true}
+            : (CartChunk){chunk.type, chunk.bank, length, ptr, false};
+
+        ptr += length;
+    }
+
+    return true;
+}
+
+#define FOR_CHUNK(view, chunk) for(const CartChunk *chunk = (view)->chunks, *MACROVAR(_end_) = chunk + (view)->count; chunk < MACROVAR(_end_); ++chunk)
+#define LOAD_CHUNK(to) readChunk(chunk, &to, sizeof(to))
+
+// zipped chunks are inflated straight into the section
+static s32 readChunk(const CartChunk* chunk, void* dst, s32 size)
+{
+    if(chunk->zip)
+        return tic_tool_unzip(dst, size, chunk->data, chunk->size);
+
+    size = MIN(size, chunk->size);
+    memcpy(dst, chunk->data, size);
+
+    return size;
+}
+
+#if defined(BUILD_DEPRECATED)
+static void loadCoverDep(tic_screen* screen, const tic_palette* palette, const CartChunk* chunk)
+{
+    // workaround to load deprecated cover section
+    gif_image* image = gif_read_data(chunk->data, chunk->size);
+
+    if (image)
+    {
+        if(image->width == TIC80_WIDTH && image->height == TIC80_HEIGHT)
+            for (s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
+                tic_tool_poke4(screen->data, i,
+                    tic_nearest_color(palette->colors, (const tic_rgb*)&image->palette[image->buffer[i]], TIC_PALETTE_SIZE));
+
+        gif_close(image);
+    }
+}
+
+static void loadDB16(tic_palettes* palette)
+{
+    // workaround to support ancient carts without palette
+    // load DB16 palette if it not exists
+    if (EMPTY(palette->vbank0.data))
+    {
+        static const u8 DB16[] = { 0x14, 0x0c, 0x1c, 0x44, 0x24, 0x34, 0x30, 0x34, 0x6d, 0x4e, 0x4a, 0x4e, 0x85, 0x4c, 0x30, 0x34, 0x65, 0x24, 0xd0, 0x46, 0x48, 0x75, 0x71, 0x61, 0x59, 0x7d, 0xce, 0xd2, 0x7d, 0x2c, 0x85, 0x95, 0xa1, 0x6d, 0xaa, 0x2c, 0xd2, 0xaa, 0x99, 0x6d, 0xc2, 0xca, 0xda, 0xd4, 0x5e, 0xde, 0xee, 0xd6 };
+        memcpy(palette->vbank0.data, DB16, sizeof DB16);
+    }
+}
+#endif
+
+// code is split into bank chunks, the highest bank goes first
+static s32 loadCode(const tic_cart_view* view, char* code, s32 size)
+{
+    s32 length = 0;
+
 #if defined(BUILD_DEPRECATED)
-        // workaround to support ancient carts without palette
-        // load DB16 palette if it not exists
-        if (EMPTY(cart->bank0.palette.vbank0.data))
+    FOR_CHUNK(view, chunk)
+        if(chunk->type == CHUNK_CODE_ZIP)
+            length = tic_tool_unzip(code, size, chunk->data, chunk->size);
+
+    if(length && *code)
+        return length;
+#endif
+
+    const CartChunk* banks[TIC_BANKS] = {0};
+
+    FOR_CHUNK(view, chunk)
+        if(chunk->type == CHUNK_CODE)
+            banks[chunk->bank] = chunk;
+
+    length = 0;
+    for(s32 i = TIC_BANKS - 1; i >= 0; i--)
+        if (banks[i])
+            length += readChunk(banks[i], code + length, size - length);
+
+    return length;
+}
+
+void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
+{
+    memset(cart, 0, sizeof(tic_cartridge));
+
+    tic_cart_view view;
+    if(!openView(&view, buffer, size))
+        return;
+
+    // load palette chunk first
+    FOR_CHUNK(&view, chunk)
+        switch (chunk->type)
         {
-            static const u8 DB16[] = { 0x14, 0x0c, 0x1c, 0x44, 0x24, 0x34, 0x30, 0x34, 0x6d, 0x4e, 0x4a, 0x4e, 0x85, 0x4c, 0x30, 0x34, 0x65, 0x24, 0xd0, 0x46, 0x48, 0x75, 0x71, 0x61, 0x59, 0x7d, 0xce, 0xd2, 0x7d, 0x2c, 0x85, 0x95, 0xa1, 0x6d, 0xaa, 0x2c, 0xd2, 0xaa, 0x99, 0x6d, 0xc2, 0xca, 0xda, 0xd4, 0x5e, 0xde, 0xee, 0xd6 };
-            memcpy(cart->bank0.palette.vbank0.data, DB16, sizeof DB16);
+        case CHUNK_PALETTE:
+            LOAD_CHUNK(cart->banks[chunk->bank].palette);
+            break;
+        case CHUNK_DEFAULT:
+            memcpy(&cart->banks[chunk->bank].palette, Sweetie16, sizeof Sweetie16);
+            memcpy(&cart->banks[chunk->bank].sfx.waveforms, Waveforms, sizeof Waveforms);
+            break;
+        default: break;
         }
+
+#if defined(BUILD_DEPRECATED)
+    loadDB16(&cart->bank0.palette);
 #endif
-    }
 
-    struct CodeChunk {s32 size; const char* data;} code[TIC_BANKS] = {0};
-    struct BinaryChunk {s32 size; const u8* data;} binary[TIC_BINARY_BANKS] = {0};
+    const CartChunk* binary[TIC_BINARY_BANKS] = {0};
 
-    {
-        const u8* ptr = buffer;
-        while(ptr < end)
+    FOR_CHUNK(&view, chunk)
+        switch(chunk->type)
         {
-            const Chunk* chunk = (Chunk*)ptr;
-            ptr += sizeof(Chunk);
-
-            switch(chunk->type)
-            {
-            case CHUNK_TILES:       LOAD_CHUNK(cart->banks[chunk->bank].tiles);             break;
-            case CHUNK_SPRITES:     LOAD_CHUNK(cart->banks[chunk->bank].sprites);           break;
-            case CHUNK_MAP:         LOAD_CHUNK(cart->banks[chunk->bank].map);               break;
-            case CHUNK_SAMPLES:     LOAD_CHUNK(cart->banks[chunk->bank].sfx.samples);       break;
-            case CHUNK_WAVEFORM:    LOAD_CHUNK(cart->banks[chunk->bank].sfx.waveforms);     break;
-            case CHUNK_MUSIC:       LOAD_CHUNK(cart->banks[chunk->bank].music.tracks);      break;
-            case CHUNK_PATTERNS:    LOAD_CHUNK(cart->banks[chunk->bank].music.patterns);    break;
-            case CHUNK_FLAGS:       LOAD_CHUNK(cart->banks[chunk->bank].flags);             break;
-            case CHUNK_SCREEN:      LOAD_CHUNK(cart->banks[chunk->bank].screen);            break;
-            case CHUNK_LANG:        LOAD_CHUNK(cart->lang);                                 break;
-            case CHUNK_BINARY:
-                binary[chunk->bank] = (struct BinaryChunk){chunkSize(chunk), ptr};
-                break;
-            case CHUNK_CODE:
-                code[chunk->bank] = (struct CodeChunk){chunkSize(chunk), (char*)ptr};
-                break;
+        case CHUNK_TILES:       LOAD_CHUNK(cart->banks[chunk->bank].tiles);             break;
+        case CHUNK_SPRITES:     LOAD_CHUNK(cart->banks[chunk->bank].sprites);           break;
+        case CHUNK_MAP:         LOAD_CHUNK(cart->banks[chunk->bank].map);               break;
+        case CHUNK_SAMPLES:     LOAD_CHUNK(cart->banks[chunk->bank].sfx.samples);       break;
+        case CHUNK_WAVEFORM:    LOAD_CHUNK(cart->banks[chunk->bank].sfx.waveforms);     break;
+        case CHUNK_MUSIC:       LOAD_CHUNK(cart->banks[chunk->bank].music.tracks);      break;
+        case CHUNK_PATTERNS:    LOAD_CHUNK(cart->banks[chunk->bank].music.patterns);    break;
+        case CHUNK_FLAGS:       LOAD_CHUNK(cart->banks[chunk->bank].flags);             break;
+        case CHUNK_SCREEN:      LOAD_CHUNK(cart->banks[chunk->bank].screen);            break;
+        case CHUNK_LANG:        LOAD_CHUNK(cart->lang);                                 break;
+        case CHUNK_BINARY:
+            if(chunk->bank < TIC_BINARY_BANKS)
+                binary[chunk->bank] = chunk;
+            break;
 #if defined(BUILD_DEPRECATED)
-            case CHUNK_CODE_ZIP:
-                tic_tool_unzip(cart->code.data, TIC_CODE_SIZE, ptr, retro_le_to_cpu16(chunk->size));
-                break;
-            case CHUNK_COVER_DEP:
-                {
-                    // workaround to load deprecated cover section
-                    gif_image* image = gif_read_data(ptr, retro_le_to_cpu16(chunk->size));
-
-                    if (image)
+        case CHUNK_COVER_DEP:
+            loadCoverDep(&cart->bank0.screen, &cart->bank0.palette.vbank0, chunk);
+            break;
+        case CHUNK_PATTERNS_DEP:
+            {
+                // workaround to load deprecated music patterns section
+                // and automatically convert volume value to a command
+                tic_patterns* ptrns = &cart->banks[chunk->bank].music.patterns;
+                LOAD_CHUNK(*ptrns);
+                for(s32 i = 0; i < MUSIC_PATTERNS; i++)
+                    for(s32 r = 0; r < MUSIC_PATTERN_ROWS; r++)
                     {
-                        if(image->width == TIC80_WIDTH && image->height == TIC80_HEIGHT)
-                            for (s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
-                                tic_tool_poke4(cart->bank0.screen.data, i,
-                                    tic_nearest_color(cart->bank0.palette.vbank0.colors, (const tic_rgb*)&image->palette[image->buffer[i]], TIC_PALETTE_SIZE));
-
-                        gif_close(image);
-                    }
-                }
-                break;
-            case CHUNK_PATTERNS_DEP:
-                {
-                    // workaround to load deprecated music patterns section
-                    // and automatically convert volume value to a command
-                    tic_patterns* ptrns = &cart->banks[chunk->bank].music.patterns;
-                    LOAD_CHUNK(*ptrns);
-                    for(s32 i = 0; i < MUSIC_PATTERNS; i++)
-                        for(s32 r = 0; r < MUSIC_PATTERN_ROWS; r++)
+                        tic_track_row* row = &ptrns->data[i].rows[r];
+                        if(row->note >= NoteStart && row->command == tic_music_cmd_empty)
                         {
-                            tic_track_row* row = &ptrns->data[i].rows[r];
-                            if(row->note >= NoteStart && row->command == tic_music_cmd_empty)
-                            {
-                                row->command = tic_music_cmd_volume;
-                                row->param2 = row->param1 = MAX_VOLUME - row->param1;
-                            }
+                            row->command = tic_music_cmd_volume;
+                            row->param2 = row->param1 = MAX_VOLUME - row->param1;
                         }
-                }
-                break;
+                    }
+            }
+            break;
 #endif
+        default: break;
+        }
+
+    for(s32 i = TIC_BINARY_BANKS - 1; i >= 0; i--)
+        if (binary[i])
+            cart->binary.size += readChunk(binary[i], cart->binary.data + cart->binary.size, TIC_BINARY_SIZE - cart->binary.size);
+
+    loadCode(&view, cart->code.data, TIC_CODE_SIZE);
+
+    closeView(&view);
+}
+
+tic_cart_view* tic_cart_view_open(const u8* buffer, s32 size)
+{
+    tic_cart_view* view = malloc(sizeof(tic_cart_view));
+
+    if(view && !openView(view, buffer, size))
+    {
+        free(view);
+        return NULL;
+    }
+
+    return view;
+}
+
+void tic_cart_view_close(tic_cart_view* view)
+{
+    if(view)
+    {
+        closeView(view);
+        free(view);
+    }
+}
+
+bool tic_cart_view_palette(const tic_cart_view* view, s32 bank, tic_palettes* palette)
+{
+    memset(palette, 0, sizeof(tic_palettes));
+
+    FOR_CHUNK(view, chunk)
+        if(chunk->bank == bank)
+            switch (chunk->type)
+            {
+            case CHUNK_PALETTE:     LOAD_CHUNK(*palette);                               break;
+            case CHUNK_DEFAULT:     memcpy(palette, Sweetie16, sizeof Sweetie16);       break;
             default: break;
             }
 
-            ptr += chunkSize(chunk);
-        }
-#undef LOAD_CHUNK
+#if defined(BUILD_DEPRECATED)
+    if(bank == 0)
+        loadDB16(palette);
+#endif
 
-        {
-            u32 total_size = 0;
-            char* ptr = cart->binary.data;
-            RFOR(const struct BinaryChunk*, chunk, binary)
-                if (chunk->size)
-                {
-                    memcpy(ptr, chunk->data, chunk->size);
-                    ptr += chunk->size;
-                    total_size += chunk->size;
-                }
-            cart->binary.size = total_size;
-        }
+    return !EMPTY(palette->vbank0.data);
+}
+
+bool tic_cart_view_screen(const tic_cart_view* view, s32 bank, tic_screen* screen)
+{
+    memset(screen, 0, sizeof(tic_screen));
 
-        if (!*cart->code.data)
+    FOR_CHUNK(view, chunk)
+        switch (chunk->type)
         {
-            char* ptr = cart->code.data;
-            RFOR(const struct CodeChunk*, chunk, code)
-                if (chunk->data)
-                {
-                    memcpy(ptr, chunk->data, chunk->size);
-                    ptr += chunk->size;
-                }
+        case CHUNK_SCREEN:
+            if(chunk->bank == bank)
+                LOAD_CHUNK(*screen);
+            break;
+#if defined(BUILD_DEPRECATED)
+        case CHUNK_COVER_DEP:
+            if(bank == 0)
+            {
+                tic_palettes palette;
+                tic_cart_view_palette(view, 0, &palette);
+                loadCoverDep(screen, &palette.vbank0, chunk);
+            }
+            break;
+#endif
+        default: break;
         }
-    }
-    // if we have allocated the buffer from a PNG chunk
-    if (chunk_cart)
-        free(chunk_cart);
+
+    return !EMPTY(screen->data);
+}
+
+s32 tic_cart_view_code(const tic_cart_view* view, char* code, s32 size)
+{
+    if(size <= 0)
+        return 0;
+
+    *code = '\0';
+    s32 length = loadCode(view, code, size - 1);
+    code[length] = '\0';
+
+    return length;
 }
 
+#undef LOAD_CHUNK
+#undef FOR_CHUNK
 
 static s32 calcBufferSize(const void* buffer, s32 size)
 {
@@ -296,8 +448,26 @@ static s32 calcBufferSize(const void* buffer, s32 size)
     return size;
 }
 
-static u8* saveFixedChunk(u8* buffer, ChunkType type, const void* from, s32 size, s32 bank)
+static u8* saveFixedChunk(u8* buffer, ChunkType type, const void* from, s32 size, s32 bank, bool zip)
 {
+    enum {MinZipSize = 16};
+
+    // the chunk is zipped only if it gets smaller, older versions skip it as unknown
+    if(zip && size > MinZipSize)
+    {
+        u8* data = buffer + sizeof(Chunk) + 1;
+        s32 zipSize = tic_tool_zip(data, size - 2, from, size);
+
+        if(zipSize)
+        {
+            Chunk chunk = {.type = CHUNK_ZIP, .bank = bank, .size = retro_le_to_cpu16(zipSize + 1), .temp = 0};
+            memcpy(buffer, &chunk, sizeof(Chunk));
+            buffer[sizeof(Chunk)] = type;
+
+            return data + zipSize;
+        }
+    }
+
     if(size)
     {
         Chunk chunk = {.type = type, .bank = bank, .size = retro_le_to_cpu16(size), .temp = 0};
@@ -311,18 +481,18 @@ static u8* saveFixedChunk(u8* buffer, ChunkType type, const void* from, s32 size
     return buffer;
 }
 
-static u8* saveChunk(u8* buffer, ChunkType type, const void* from, s32 size, s32 bank)
+static u8* saveChunk(u8* buffer, ChunkType type, const void* from, s32 size, s32 bank, bool zip)
 {
     s32 chunkSize = calcBufferSize(from, size);
 
-    return saveFixedChunk(buffer, type, from, chunkSize, bank);
+    return saveFixedChunk(buffer, type, from, chunkSize, bank, zip);
 }
 
-s32 tic_cart_save(const tic_cartridge* cart, u8* buffer)
+static s32 saveCart(const tic_cartridge* cart, u8* buffer, bool zip)
 {
     u8* start = buffer;
 
-#define SAVE_CHUNK(ID, FROM, BANK) saveChunk(buffer, ID, &FROM, sizeof(FROM), BANK)
+#define SAVE_CHUNK(ID, FROM, BANK) saveChunk(buffer, ID, &FROM, sizeof(FROM), BANK, zip)
 
     tic_waveforms defaultWaveforms = {0};
     tic_palettes defaultPalettes = {0};
@@ -362,14 +532,14 @@ s32 tic_cart_save(const tic_cartridge* cart, u8* buffer)
         s32 remaining = cart->binary.size;
         for (s32 i = cart->binary.size / TIC_BANK_SIZE; i >= 0; --i, ptr += TIC_BANK_SIZE)
         {
-            buffer = saveFixedChunk(buffer, CHUNK_BINARY, ptr, MIN(remaining, TIC_BANK_SIZE), i);
+            buffer = saveFixedChunk(buffer, CHUNK_BINARY, ptr, MIN(remaining, TIC_BANK_SIZE), i, zip);
             remaining -= TIC_BANK_SIZE;
         }
     }
 
     ptr = cart->code.data;
     for(s32 i = strlen(ptr) / TIC_BANK_SIZE; i >= 0; --i, ptr += TIC_BANK_SIZE)
-        buffer = saveFixedChunk(buffer, CHUNK_CODE, ptr, MIN(strlen(ptr), TIC_BANK_SIZE), i);
+        buffer = saveFixedChunk(buffer, CHUNK_CODE, ptr, MIN(strlen(ptr), TIC_BANK_SIZE), i, zip);
 
     if(cart->lang)
         SAVE_CHUNK(CHUNK_LANG, cart->lang, 0);
@@ -378,3 +548,13 @@ s32 tic_cart_save(const tic_cartridge* cart, u8* buffer)
 
     return (s32)(buffer - start);
 }
+
+s32 tic_cart_save(const tic_cartridge* cart, u8* buffer)
+{
+    return saveCart(cart, buffer, false);
+}
+
+s32 tic_cart_save_zip(const tic_cartridge* cart, u8* buffer)
+{
+    return saveCart(cart, buffer, true);
+}
@@ -26,3 +26,17 @@
 
 void tic_cart_load(tic_cartridge* rom, const u8* buffer, s32 size);
 s32  tic_cart_save(const tic_cartridge* rom, u8* buffer);
+
+// same as above with every chunk zipped when it gets smaller,
+// older versions skip the zipped chunks and load those sections empty
+s32  tic_cart_save_zip(const tic_cartridge* rom, u8* buffer);
+
+// chunk directory over a cart buffer, sections are copied out on demand
+// the buffer must outlive the view (png carts are decoded into the view)
+typedef struct tic_cart_view tic_cart_view;
+
+tic_cart_view* tic_cart_view_open(const u8* buffer, s32 size);
+void tic_cart_view_close(tic_cart_view* view);
+bool tic_cart_view_palette(const tic_cart_view* view, s32 bank, tic_palettes* palette);
+bool tic_cart_view_screen(const tic_cart_view* view, s32 bank, tic_screen* screen);
+s32  tic_cart_view_code(const tic_cart_view* view, char* code, s32 size);
@@ -70,6 +70,14 @@ u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
     return 0;
 }
 
+static inline void touchPMem(tic_core* core, s64 address, s32 size)
+{
+    enum {Start = offsetof(tic_ram, persistent), End = Start + sizeof(tic_persistent)};
+
+    if(address < End && address + size > Start)
+        core->state.pmem = true;
+}
+
 void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
 {
     if (address < 0)
@@ -86,6 +94,8 @@ void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
     case 4: if(address < RamBits / 4) tic_tool_poke4(ram, address, value); break;
     case 8: if(address < RamBits / 8) ram[address] = value; break;
     }
+
+    touchPMem(core, (s64)address * bits / BITS_IN_BYTE, 1);
 }
 
 u8 tic_api_peek4(tic_mem* memory, s32 address)
@@ -132,6 +142,7 @@ void tic_api_memcpy(tic_mem* memory, s32 dst, s32 src, s32 size)
     {
         u8* base = (u8*)memory->ram;
         memmove(base + dst, base + src, size);
+        touchPMem(core, dst, size);
     }
 }
 
@@ -147,6 +158,7 @@ void tic_api_memset(tic_mem* memory, s32 dst, u8 val, s32 size)
     {
         u8* base = (u8*)memory->ram;
         memset(base + dst, val, size);
+        touchPMem(core, dst, size);
     }
 }
 
@@ -161,7 +173,10 @@ u32 tic_api_pmem(tic_mem* tic, s32 index, u32 value, bool set)
     u32 old = tic->ram->persistent.data[index];
 
     if (set)
+    {
         tic->ram->persistent.data[index] = value;
+        ((tic_core*)tic)->state.pmem = true;
+    }
 
     return old;
 }
@@ -283,7 +298,6 @@ static void soundClear(tic_mem* memory)
 
     memset(&memory->ram->registers, 0, sizeof memory->ram->registers);
     memset(&memory->ram->pcm, 0, sizeof memory->ram->pcm);
-    memset(memory->product.samples.buffer, 0, memory->product.samples.count * TIC80_SAMPLESIZE);
 
     tic_api_music(memory, -1, 0, 0, false, false, -1, -1);
 }
@@ -443,7 +457,7 @@ void tic_core_tick(tic_mem* tic, tic_tick_data* data)
 
     if (fftEnabled)
     {
-        FFT_GetFFT(fftData);
+        fftDirty = true;
     }
     if (!core->state.initialized)
     {
@@ -614,6 +628,18 @@ static inline void updpal(tic_mem* tic, tic_blitpal* pal0, tic_blitpal* pal1)
     *pal1 = tic_tool_palette_blit(&vbank1(core)->palette, core->screen_format);
 }
 
+static inline void blitrow(tic80* product, s32 row, const u32* line)
+{
+    u32* dst = product->screen + row * TIC80_FULLWIDTH;
+
+    // only touch (and report) the rows that differ from the previous frame
+    if(memcmp(dst, line, TIC80_FULLWIDTH * sizeof(u32)))
+    {
+        memcpy(dst, line, TIC80_FULLWIDTH * sizeof(u32));
+        TIC80_SET_ROW_DIRTY(product, row);
+    }
+}
+
 static inline void updbdr(tic_mem* tic, s32 row, u32* ptr, tic_blit_callback clb, tic_blitpal* pal0, tic_blitpal* pal1)
 {
     tic_core* core = (tic_core*)tic;
@@ -651,17 +677,22 @@ void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb)
     updpal(tic, &pal0, &pal1);
 
     s32 row = 0;
-    u32* rowPtr = tic->product.screen;
+    u32 line[TIC80_FULLWIDTH];
+
+    ZEROMEM(tic->product.dirty);
 
-#define UPDBDR() updbdr(tic, row, rowPtr, clb, &pal0, &pal1)
+#define UPDBDR() updbdr(tic, row, line, clb, &pal0, &pal1)
 
-    for(; row != TIC80_MARGIN_TOP; ++row, rowPtr += TIC80_FULLWIDTH)
+    for(; row != TIC80_MARGIN_TOP; ++row)
+    {
         UPDBDR();
+        blitrow(&tic->product, row, line);
+    }
 
     for(; row != TIC80_FULLHEIGHT - TIC80_MARGIN_BOTTOM; ++row)
     {
         UPDBDR();
-        rowPtr += TIC80_MARGIN_LEFT;
+        u32* rowPtr = line + TIC80_MARGIN_LEFT;
 
         if(*(u16*)&vbank0(core)->vars.offset == 0 && *(u16*)&vbank1(core)->vars.offset == 0)
         {
@@ -683,15 +714,36 @@ void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb)
                     (x + offsetX1) % TIC80_WIDTH + start1, &pal0, &pal1);
         }
 
-        rowPtr += TIC80_MARGIN_RIGHT;
+        blitrow(&tic->product, row, line);
     }
 
-    for(; row != TIC80_FULLHEIGHT; ++row, rowPtr += TIC80_FULLWIDTH)
+    for(; row != TIC80_FULLHEIGHT; ++row)
+    {
         UPDBDR();
+        blitrow(&tic->product, row, line);
+    }
 
 #undef  UPDBDR
 }
 
+// overlays drawn straight into `product.screen` after the blit
+// (cursor, popups, etc) have to report the rows they touched
+void tic_core_invalidate_rows(tic_mem* tic, s32 row, s32 count)
+{
+    for(s32 i = MAX(row, 0), end = MIN(row + count, TIC80_FULLHEIGHT); i < end; ++i)
+        TIC80_SET_ROW_DIRTY(&tic->product, i);
+}
+
+// a VM mapping the ram directly (wasm) writes it without the api, it's always reported
+bool tic_core_pmem_dirty(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    bool dirty = core->state.pmem || memory->ram != memory->base_ram;
+
+    core->state.pmem = false;
+    return dirty;
+}
+
 static inline void scanline(tic_mem* memory, s32 row, void* data)
 {
     tic_core* core = (tic_core*)memory;
@@ -713,6 +765,32 @@ void tic_core_blit(tic_mem* tic)
     tic_core_blit_ex(tic, (tic_blit_callback){scanline, border, NULL});
 }
 
+void tic_core_samplerate(tic_mem* memory, s32 samplerate)
+{
+    tic_core* core = (tic_core*)memory;
+    tic80* product = &memory->product;
+
+    core->samplerate = samplerate;
+    core->samplecarry = 0;
+    ZEROMEM(core->wavetable);
+
+    // the frame length alternates between floor and ceil of samplerate / TIC80_FRAMERATE,
+    // so the buffer is sized for the longer one
+    product->samples.count = samplerate / TIC80_FRAMERATE * TIC80_SAMPLE_CHANNELS;
+    product->samples.buffer = realloc(product->samples.buffer,
+        (samplerate + TIC80_FRAMERATE - 1) / TIC80_FRAMERATE * TIC80_SAMPLE_CHANNELS * TIC80_SAMPLESIZE);
+    memset(product->samples.buffer, 0, product->samples.count * TIC80_SAMPLESIZE);
+
+    blip_delete(core->blip.left);
+    blip_delete(core->blip.right);
+
+    core->blip.left = blip_new(samplerate / 10);
+    core->blip.right = blip_new(samplerate / 10);
+
+    blip_set_rates(core->blip.left, CLOCKRATE, samplerate);
+    blip_set_rates(core->blip.right, CLOCKRATE, samplerate);
+}
+
 tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
 {
     tic_core* core = (tic_core*)malloc(sizeof(tic_core));
@@ -723,7 +801,6 @@ tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
     core->screen_format = format;
     core->memory.ram = (tic_ram*)malloc(TIC_RAM_SIZE);
     core->memory.base_ram = core->memory.ram;
-    core->samplerate = samplerate;
 
     memset(core->memory.ram, 0, sizeof(tic_ram));
 #ifdef __3DS__
@@ -734,14 +811,11 @@ tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
 #else
     product->screen = malloc(TIC80_FULLWIDTH * TIC80_FULLHEIGHT * sizeof product->screen[0]);
 #endif
-    product->samples.count = samplerate * TIC80_SAMPLE_CHANNELS / TIC80_FRAMERATE;
-    product->samples.buffer = malloc(product->samples.count * TIC80_SAMPLESIZE);
-
-    core->blip.left = blip_new(samplerate / 10);
-    core->blip.right = blip_new(samplerate / 10);
+    memset(product->screen, 0, TIC80_FULLWIDTH * TIC80_FULLHEIGHT * sizeof product->screen[0]);
 
-    blip_set_rates(core->blip.left, CLOCKRATE, samplerate);
-    blip_set_rates(core->blip.right, CLOCKRATE, samplerate);
+    tic_core_samplerate(&core->memory, samplerate);
+    tic_core_sound_target(&core->memory, TIC_SOUND_LATENCY);
+    tic_core_sound_burst(&core->memory, 1);
 
     {
 #define API_FUNC_DEF(name, ...) core->api.name = tic_api_ ## name;
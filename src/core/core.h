@@ -29,6 +29,9 @@
 #define CLOCKRATE (255<<13)
 #define TIC_DEFAULT_COLOR 15
 #define TIC_SOUND_RINGBUF_LEN 12 // in worst case, this induces ~ 12 tick delay i.e. 200 ms
+#define TIC_STREAM_FRAME (TIC_STREAM_MAXRATE / TIC80_FRAMERATE + 2) // most stream() samples played in a tick
+#define TIC_SOUND_LATENCY 2 // ring buffer depth in ticks the synth converges on
+#define TIC_WAVETABLE_SIZE 128
 
 typedef struct
 {
@@ -95,6 +98,18 @@ typedef struct
     s32 beat;
 } tic_jump_command;
 
+// stream() parameters and play position, advanced every tick by tic_core_sound_tick_end
+typedef struct
+{
+    s32 offset;
+    s32 length; // 0 - stopped
+    s32 rate;
+    u8 volume;
+    bool loop;
+    s32 pos;
+    s32 time; // in 1/256 clocks
+} tic_stream_register;
+
 typedef struct
 {
 
@@ -114,30 +129,13 @@ typedef struct
         u32 holds[tic_keys_count];
     } keyboard;
 
-    struct
-    {
-        struct sound_register_data
-        {
-            tic_sound_register_data data[TIC_SOUND_CHANNELS];
-            tic_sound_register_data pcm;
-        } left, right;
-    } registers;
-
-    struct sound_ring_buf
-    {
-        tic_sound_register registers[TIC_SOUND_CHANNELS];
-        tic_stereo_volume stereo;
-        tic_pcm pcm;
-    } sound_ringbuf[TIC_SOUND_RINGBUF_LEN];
-
-    u32 sound_ringbuf_head;
-    u32 sound_ringbuf_tail;
-
     struct
     {
         tic_channel_data channels[TIC_SOUND_CHANNELS];
     } sfx;
 
+    tic_stream_register stream;
+
     struct
     {
         s32 ticks;
@@ -154,6 +152,9 @@ typedef struct
 
     u32 synced;
 
+    // persistent memory was written since the last tic_core_pmem_dirty()
+    bool pmem;
+
     struct
     {
         s32 id;
@@ -182,7 +183,71 @@ typedef struct
         struct blip_t* right;
     } blip;
 
+    // band-limited cycles used by the synth for high pitched channels
+    struct
+    {
+        tic_waveform waveform;
+        s32 period;
+        float data[TIC_WAVETABLE_SIZE + 1];
+    } wavetable[TIC_SOUND_CHANNELS];
+
     s32 samplerate;
+    // remainder of samplerate / TIC80_FRAMERATE carried between frames
+    s32 samplecarry;
+
+    // ring buffer backlog, written by the synth
+    struct
+    {
+        s32 target; // ticks
+        s32 burst;  // ticks synthesized back to back per host callback
+        s32 depth;  // smoothed, in 1/256 ticks
+    } latency;
+
+    // every voice's own output before mixing, written by the synth
+    struct
+    {
+        s16 data[TIC_AUDIOTAP_CHANNELS][TIC_AUDIOTAP_SIZE];
+        u32 head; // samples written
+    } audiotap;
+
+    // the synth voices and the register ring buffer feeding them, shared with the
+    // audio thread, so they are kept out of state where reset and pause would clobber them
+    struct
+    {
+        struct sound_register_data
+        {
+            tic_sound_register_data data[TIC_SOUND_CHANNELS];
+            tic_sound_register_data pcm;
+        } left, right;
+
+        struct sound_stream_data
+        {
+            s32 amp[2];
+        } stream;
+    } registers;
+
+    struct sound_ring_buf
+    {
+        tic_sound_register registers[TIC_SOUND_CHANNELS];
+        tic_stereo_volume stereo;
+        tic_pcm pcm;
+
+        // the stream() samples of the tick, copied out of the cart binary
+        // so the synth never reads the cart while a new one is loaded
+        struct sound_stream_frame
+        {
+            s32 time; // of the first sample, in 1/256 clocks
+            s32 period;
+            s32 count;
+            u8 volume;
+            bool stop; // the stream ends after the last sample
+            u8 data[TIC_STREAM_FRAME];
+        } stream;
+    } sound_ringbuf[TIC_SOUND_RINGBUF_LEN];
+
+    u32 sound_ringbuf_head;
+    u32 sound_ringbuf_tail;
+
     tic_tick_data* data;
     tic_core_state_data state;
 
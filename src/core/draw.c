@@ -149,13 +149,28 @@ static void drawRectBorder(tic_core* core, s32 x, s32 y, s32 width, s32 height,
     } \
     } while(0)
 
+// SCALE is a compile time constant for the common scales, so the divisions
+// below turn into shifts/multiplies; every source pixel is written as a span
+#define DRAW_SCALED_TILE_BODY(SCALE) do {\
+    for(s32 py = sy; py < ey; py++) \
+    { \
+        const u8* src = pixels + (py / (SCALE)) * TIC_SPRITESIZE; \
+        u32 start = (y + py) * TIC80_WIDTH + x; \
+        for(s32 px = sx; px < ex;) \
+        { \
+            s32 col = px / (SCALE); \
+            s32 end = MIN((col + 1) * (SCALE), ex); \
+            u8 color = src[col]; \
+            if(color == TRANSPARENT_COLOR) px = end; \
+            else for(; px < end; px++) tic_tool_poke4(screen, start + px, color); \
+        } \
+    } \
+    } while(0)
+
 #define REVERT(X) (TIC_SPRITESIZE - 1 - (X))
 
-static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
+static inline u32 tileOrientation(tic_flip flip, tic_rotate rotate)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-    u8* mapping = getPalette(&core->memory, colors, count);
-
     rotate &= 3;
     u32 orientation = flip & 3;
 
@@ -164,6 +179,47 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
     else if (rotate == tic_270_rotate) orientation ^= 2;
     if (rotate == tic_90_rotate || rotate == tic_270_rotate) orientation |= 4;
 
+    return orientation;
+}
+
+static void drawTileScaled(tic_core* core, tic_tileptr* tile, s32 x, s32 y, const u8* mapping, s32 scale, u32 orientation)
+{
+    const s32 size = TIC_SPRITESIZE * scale;
+
+    // clip the whole scaled tile once instead of every scaled pixel
+    s32 sx, sy, ex, ey;
+    sx = core->state.clip.l - x; if (sx < 0) sx = 0;
+    sy = core->state.clip.t - y; if (sy < 0) sy = 0;
+    ex = core->state.clip.r - x; if (ex > size) ex = size;
+    ey = core->state.clip.b - y; if (ey > size) ey = size;
+
+    if (sx >= ex || sy >= ey) return;
+
+    // flip/rotate and map the tile once, the span loops only read this buffer
+    u8 pixels[TIC_SPRITESIZE * TIC_SPRITESIZE];
+    for (s32 py = 0, i = 0; py < TIC_SPRITESIZE; py++)
+        for (s32 px = 0; px < TIC_SPRITESIZE; px++, i++)
+        {
+            s32 ix = orientation & 1 ? REVERT(px) : px;
+            s32 iy = orientation & 2 ? REVERT(py) : py;
+            if (orientation & 4) {
+                s32 tmp = ix; ix = iy; iy = tmp;
+            }
+            pixels[i] = mapping[tic_tilesheet_gettilepix(tile, ix, iy)];
+        }
+
+    u8* screen = core->memory.ram->vram.screen.data;
+
+    switch (scale) {
+    case 2: DRAW_SCALED_TILE_BODY(2); break;
+    case 3: DRAW_SCALED_TILE_BODY(3); break;
+    case 4: DRAW_SCALED_TILE_BODY(4); break;
+    default: DRAW_SCALED_TILE_BODY(scale); break;
+    }
+}
+
+static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, const u8* mapping, s32 scale, u32 orientation)
+{
     if (scale == 1) {
         // the most common path
         s32 sx, sy, ex, ey;
@@ -186,25 +242,12 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
         return;
     }
 
-    if (EARLY_CLIP(x, y, TIC_SPRITESIZE * scale, TIC_SPRITESIZE * scale)) return;
-
-    for (s32 py = 0; py < TIC_SPRITESIZE; py++, y += scale)
-    {
-        s32 xx = x;
-        for (s32 px = 0; px < TIC_SPRITESIZE; px++, xx += scale)
-        {
-            s32 ix = orientation & 1 ? TIC_SPRITESIZE - px - 1 : px;
-            s32 iy = orientation & 2 ? TIC_SPRITESIZE - py - 1 : py;
-            if (orientation & 4) {
-                s32 tmp = ix; ix = iy; iy = tmp;
-            }
-            u8 color = mapping[tic_tilesheet_gettilepix(tile, ix, iy)];
-            if (color != TRANSPARENT_COLOR) drawRect(core, xx, y, scale, scale, color);
-        }
-    }
+    if (scale > 1)
+        drawTileScaled(core, tile, x, y, mapping, scale, orientation);
 }
 
 #undef DRAW_TILE_BODY
+#undef DRAW_SCALED_TILE_BODY
 #undef REVERT
 
 static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
@@ -218,53 +261,42 @@ static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8
     flip &= 3;
 
     tic_tilesheet sheet = getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment);
+
+    // palette mapping and orientation are shared by all the sub-tiles
+    const u8* mapping = getPalette(&core->memory, colors, count);
+    const u32 orientation = tileOrientation(flip, rotate);
+
     if (w == 1 && h == 1) {
         tic_tileptr tile = tic_tilesheet_gettile(&sheet, index, false);
-        drawTile(core, &tile, x, y, colors, count, scale, flip, rotate);
+        drawTile(core, &tile, x, y, mapping, scale, orientation);
     }
     else
     {
         s32 step = TIC_SPRITESIZE * scale;
         s32 cols = sheet.segment->sheet_width;
 
-        const tic_flip vert_horz_flip = tic_horz_flip | tic_vert_flip;
-
         if (EARLY_CLIP(x, y, w * step, h * step)) return;
 
+        // resolve the sub-tile order once: the orientation bits mirror the
+        // tile grid, and 90/270 rotations (bit 4) transpose it
+        const bool rotated = orientation & 4;
+        const bool mirrorX = orientation & (rotated ? 2 : 1);
+        const bool mirrorY = orientation & (rotated ? 1 : 2);
+
         for (s32 i = 0; i < w; i++)
         {
             for (s32 j = 0; j < h; j++)
             {
-                s32 mx = i;
-                s32 my = j;
-
-                if (flip == tic_horz_flip || flip == vert_horz_flip) mx = w - 1 - i;
-                if (flip == tic_vert_flip || flip == vert_horz_flip) my = h - 1 - j;
-
-                if (rotate == tic_180_rotate)
-                {
-                    mx = w - 1 - mx;
-                    my = h - 1 - my;
-                }
-                else if (rotate == tic_90_rotate)
-                {
-                    if (flip == tic_no_flip || flip == vert_horz_flip) my = h - 1 - my;
-                    else mx = w - 1 - mx;
-                }
-                else if (rotate == tic_270_rotate)
-                {
-                    if (flip == tic_no_flip || flip == vert_horz_flip) mx = w - 1 - mx;
-                    else my = h - 1 - my;
-                }
-
-                enum { Cols = TIC_SPRITESHEET_SIZE / TIC_SPRITESIZE };
+                s32 tx = x + (rotated ? j : i) * step;
+                s32 ty = y + (rotated ? i : j) * step;
+
+                if (EARLY_CLIP(tx, ty, step, step)) continue;
 
+                s32 mx = mirrorX ? w - 1 - i : i;
+                s32 my = mirrorY ? h - 1 - j : j;
 
                 tic_tileptr tile = tic_tilesheet_gettile(&sheet, index + mx + my * cols, false);
-                if (rotate == 0 || rotate == 2)
-                    drawTile(core, &tile, x + i * step, y + j * step, colors, count, scale, flip, rotate);
-                else
-                    drawTile(core, &tile, x + j * step, y + i * step, colors, count, scale, flip, rotate);
+                drawTile(core, &tile, tx, ty, mapping, scale, orientation);
             }
         }
     }
@@ -275,6 +307,7 @@ static void drawMap(tic_core* core, const tic_map* src, s32 x, s32 y, s32 width,
     const s32 size = TIC_SPRITESIZE * scale;
 
     tic_tilesheet sheet = getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment);
+    const u8* mapping = getPalette(&core->memory, colors, count);
 
     for (s32 j = y, jj = sy; j < y + height; j++, jj += size)
         for (s32 i = x, ii = sx; i < x + width; i++, ii += size)
@@ -289,7 +322,7 @@ static void drawMap(tic_core* core, const tic_map* src, s32 x, s32 y, s32 width,
                 remap(data, mi, mj, &retile);
 
             tic_tileptr tile = tic_tilesheet_gettile(&sheet, retile.index, true);
-            drawTile(core, &tile, ii, jj, colors, count, scale, retile.flip, retile.rotate);
+            drawTile(core, &tile, ii, jj, mapping, scale, tileOrientation(retile.flip, retile.rotate));
         }
 }
 
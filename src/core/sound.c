@@ -26,6 +26,7 @@
 
 #include <string.h>
 #include <limits.h>
+#include <math.h>
 #include "tic_assert.h"
 #include "blip_buf.h"
 
@@ -34,6 +35,8 @@
 #define NOTES_PER_MINUTE (TIC80_FRAMERATE / NOTES_PER_BEAT * SECONDS_PER_MINUTE)
 #define PIANO_START 8
 #define ENDTIME (CLOCKRATE / TIC80_FRAMERATE)
+#define WAVETABLE_SIZE TIC_WAVETABLE_SIZE
+#define PI 3.14159265358979f
 
 static const u16 NoteFreqs[] = { 0x10, 0x11, 0x12, 0x13, 0x15, 0x16, 0x17, 0x18, 0x1a, 0x1c, 0x1d, 0x1f, 0x21, 0x23, 0x25, 0x27, 0x29, 0x2c, 0x2e, 0x31, 0x34, 0x37, 0x3a, 0x3e, 0x41, 0x45, 0x49, 0x4e, 0x52, 0x57, 0x5c, 0x62, 0x68, 0x6e, 0x75, 0x7b, 0x83, 0x8b, 0x93, 0x9c, 0xa5, 0xaf, 0xb9, 0xc4, 0xd0, 0xdc, 0xe9, 0xf7, 0x106, 0x115, 0x126, 0x137, 0x14a, 0x15d, 0x172, 0x188, 0x19f, 0x1b8, 0x1d2, 0x1ee, 0x20b, 0x22a, 0x24b, 0x26e, 0x293, 0x2ba, 0x2e4, 0x310, 0x33f, 0x370, 0x3a4, 0x3dc, 0x417, 0x455, 0x497, 0x4dd, 0x527, 0x575, 0x5c8, 0x620, 0x67d, 0x6e0, 0x749, 0x7b8, 0x82d, 0x8a9, 0x92d, 0x9b9, 0xa4d, 0xaea, 0xb90, 0xc40, 0xcfa, 0xdc0, 0xe91, 0xf6f, 0x105a, 0x1153, 0x125b, 0x1372, 0x149a, 0x15d4, 0x1720, 0x1880 };
 static_assert(COUNT_OF(NoteFreqs) == NOTES * OCTAVES + PIANO_START, "count_of_freqs");
@@ -80,11 +83,15 @@ static inline s32 param2val(const tic_track_row* row)
     return (row->param1 << 4) | row->param2;
 }
 
-static void update_amp(blip_buffer_t* blip, tic_sound_register_data* data, s32 new_amp)
+static inline void update_amp(blip_buffer_t* blip, s32* amp, s32 time, s32 new_amp)
 {
-    s32 delta = new_amp - data->amp;
-    data->amp += delta;
-    blip_add_delta(blip, data->time, delta);
+    s32 delta = new_amp - *amp;
+
+    if(delta)
+    {
+        *amp = new_amp;
+        blip_add_delta(blip, time, delta);
+    }
 }
 
 static inline s32 freq2period(s32 freq)
@@ -106,28 +113,244 @@ static inline s32 getAmp(s32 volume, s32 amp)
     return amp * volume / MAX_VOLUME / (TIC_SOUND_CHANNELS + 1);
 }
 
-static void runPcm(blip_buffer_t* blip, const tic_pcm* pcm, tic_sound_register_data* data)
+// records the voice's own output at every output sample point of the frame,
+// the amplitude is a step function so a point takes the value set before it
+typedef struct
+{
+    s16* data;
+    u32 head;
+    s32 points;
+    s32 next;
+    s32 time;   // of the next point
+} AudioTap;
+
+static inline void tapVoice(AudioTap* tap, s32 time, s32 left, s32 right)
+{
+    if(tap->time < time)
+    {
+        s32 value = (left + right) / 2 * (TIC_SOUND_CHANNELS + 1);
+        value = CLAMP(value, SHRT_MIN, SHRT_MAX);
+
+        do
+        {
+            tap->data[(tap->head + tap->next) % TIC_AUDIOTAP_SIZE] = value;
+            tap->time = ++tap->next * ENDTIME / tap->points;
+        }
+        while(tap->time < time);
+    }
+}
+
+// left and right channels always step through the same phases, only the
+// stereo volume differs, so both blip buffers are fed from a single pass
+typedef struct
+{
+    blip_buffer_t* blip[2];
+    tic_sound_register_data* data[2];
+    u8 volume[2];
+    AudioTap tap;
+} StereoVoice;
+
+static inline void updateVoice(StereoVoice* voice, s32 time, s32 left, s32 right)
+{
+    tapVoice(&voice->tap, time, voice->data[0]->amp, voice->data[1]->amp);
+    update_amp(voice->blip[0], &voice->data[0]->amp, time, left);
+    update_amp(voice->blip[1], &voice->data[1]->amp, time, right);
+}
+
+static void runPcm(StereoVoice* voice, const tic_pcm* pcm)
 {
     enum{Period = ENDTIME / TIC_PCM_SIZE};
 
+    tic_sound_register_data* data = voice->data[0];
+
     for (data->time = 0; data->time < ENDTIME; data->time += Period, data->phase = (data->phase + 1) % TIC_PCM_SIZE)
     {
-        update_amp(blip, data, getAmp(MAX_VOLUME, pcm->data[data->phase] * SHRT_MAX / UCHAR_MAX));
+        s32 amp = getAmp(MAX_VOLUME, pcm->data[data->phase] * SHRT_MAX / UCHAR_MAX);
+        updateVoice(voice, data->time, amp, amp);
+    }
+}
+
+// plays the stream() samples copied into the ring buffer slot by tic_core_sound_tick_end
+static void runStream(tic_core* core, const struct sound_stream_frame* frame, AudioTap* tap)
+{
+    struct sound_stream_data* voice = &core->registers.stream;
+    blip_buffer_t* blip[] = {core->blip.left, core->blip.right};
+
+    s32 time = frame->time;
+
+    for(s32 i = 0; i < frame->count; i++, time += frame->period)
+    {
+        s32 amp = getAmp(frame->volume, (frame->data[i] - 128) * SHRT_MAX / 128);
+
+        tapVoice(tap, time >> 8, voice->amp[0], voice->amp[1]);
+
+        for(s32 side = 0; side < COUNT_OF(blip); side++)
+            update_amp(blip[side], &voice->amp[side], time >> 8, amp);
+    }
+
+    if(frame->stop)
+    {
+        tapVoice(tap, time >> 8, voice->amp[0], voice->amp[1]);
+
+        for(s32 side = 0; side < COUNT_OF(blip); side++)
+            update_amp(blip[side], &voice->amp[side], time >> 8, 0);
+    }
+}
+
+// skips the steps left in the frame without producing any deltas
+static void skipEnvelope(tic_sound_register_data* data, s32 period)
+{
+    if(data->time < ENDTIME)
+    {
+        s32 steps = (ENDTIME - data->time + period - 1) / period;
+
+        data->time += steps * period;
+        data->phase = (data->phase + steps) % WAVE_VALUES;
+    }
+}
+
+// one cycle of the waveform staircase with the harmonics above nyquist removed,
+// hold is the part of the cycle each resampled value is held for
+static void buildWavetable(float* table, const u8* waveform, s32 harmonics, float hold)
+{
+    float values[WAVE_VALUES];
+    float dc = 0;
+
+    for(s32 n = 0; n < WAVE_VALUES; n++)
+        dc += values[n] = tic_tool_peek4(waveform, n);
+
+    for(s32 k = 0; k < WAVETABLE_SIZE; k++)
+        table[k] = dc / WAVE_VALUES;
+
+    for(s32 h = 1; h <= harmonics; h++)
+    {
+        float theta = 2 * PI * h / WAVE_VALUES;
+
+        // DFT bin of the wave values
+        float re = 0, im = 0, wr = cosf(theta), wi = -sinf(theta), zr = 1, zi = 0;
+        for(s32 n = 0; n < WAVE_VALUES; n++)
+        {
+            re += values[n] * zr;
+            im += values[n] * zi;
+
+            float t = zr * wr - zi * wi;
+            zi = zr * wi + zi * wr;
+            zr = t;
+        }
+
+        // every value is held for a whole step: sinc gain and half a step of delay,
+        // the droop of holding the resampled values is compensated as well
+        float droop = PI * h * hold;
+        float gain = 2 * sinf(theta / 2) / (theta / 2) / WAVE_VALUES * droop / sinf(droop);
+        float cr = gain * (re * cosf(theta / 2) + im * sinf(theta / 2));
+        float ci = gain * (im * cosf(theta / 2) - re * sinf(theta / 2));
+
+        wr = cosf(2 * PI * h / WAVETABLE_SIZE);
+        wi = sinf(2 * PI * h / WAVETABLE_SIZE);
+        zr = 1, zi = 0;
+
+        for(s32 k = 0; k < WAVETABLE_SIZE; k++)
+        {
+            table[k] += cr * zr - ci * zi;
+
+            float t = zr * wr - zi * wi;
+            zi = zr * wi + zi * wr;
+            zr = t;
+        }
+    }
+
+    table[WAVETABLE_SIZE] = table[0];
+}
+
+// when the steps are denser than the output samples, the band-limited cycle is
+// resampled once per point instead, so the cost doesn't depend on the pitch
+static void runWavetable(tic_core* core, s32 channel, StereoVoice* voice, const tic_sound_register* reg, s32 period, s32 points)
+{
+    tic_sound_register_data* data = voice->data[0];
+    float* table = core->wavetable[channel].data;
+
+    // notes usually hold for many frames, rebuild only when the tone changes
+    if(core->wavetable[channel].period != period || !MEMCMP(core->wavetable[channel].waveform, reg->waveform))
+    {
+        // harmonics below nyquist of the output rate
+        s32 harmonics = MIN((points * period * WAVE_VALUES - 1) / (2 * ENDTIME), WAVETABLE_SIZE / 2 - 1);
+
+        buildWavetable(table, reg->waveform.data, harmonics, (float)ENDTIME / (points * period * WAVE_VALUES));
+
+        core->wavetable[channel].period = period;
+        core->wavetable[channel].waveform = reg->waveform;
     }
+
+    float scale[2];
+    for(s32 side = 0; side < 2; side++)
+        scale[side] = (float)SHRT_MAX * voice->volume[side] * reg->volume
+            / (MAX_VOLUME * MAX_VOLUME * MAX_VOLUME * (TIC_SOUND_CHANNELS + 1));
+
+    // waveform position in table units, the value is held until the next point
+    // so the middle of the span is sampled
+    const float Scale = (float)WAVETABLE_SIZE / WAVE_VALUES;
+    float delta = (float)ENDTIME / points / period * Scale;
+    float pos = (data->phase - (float)data->time / period) * Scale + delta / 2;
+
+    while(pos < 0) pos += WAVETABLE_SIZE;
+
+    for(s32 i = 0; i < points; i++, pos += delta)
+    {
+        while(pos >= WAVETABLE_SIZE) pos -= WAVETABLE_SIZE;
+
+        s32 index = (s32)pos;
+        float value = table[index] + (table[index + 1] - table[index]) * (pos - index);
+
+        s32 amp[2];
+        for(s32 side = 0; side < 2; side++)
+        {
+            float v = value * scale[side];
+            amp[side] = (s32)(v < 0 ? v - 0.5f : v + 0.5f);
+        }
+
+        updateVoice(voice, i * ENDTIME / points, amp[0], amp[1]);
+    }
+
+    skipEnvelope(data, period);
 }
 
-static void runEnvelope(blip_buffer_t* blip, const tic_sound_register* reg, tic_sound_register_data* data, u8 stereo_volume)
+static void runEnvelope(tic_core* core, s32 channel, StereoVoice* voice, const tic_sound_register* reg, s32 points)
 {
+    tic_sound_register_data* data = voice->data[0];
     s32 period = freq2period(tic_sound_register_get_freq(reg) * ENVELOPE_FREQ_SCALE);
 
-    for (; data->time < ENDTIME; data->time += period, data->phase = (data->phase + 1) % WAVE_VALUES)
+    // the phase is still the noise LFSR state when the channel switches from noise,
+    // it would index past the waveform
+    data->phase %= WAVE_VALUES;
+
+    if(reg->volume == 0 || (voice->volume[0] | voice->volume[1]) == 0)
+    {
+        if(data->time < ENDTIME)
+            updateVoice(voice, data->time, 0, 0);
+
+        skipEnvelope(data, period);
+    }
+    else if(period * points < ENDTIME)
     {
-        update_amp(blip, data, getAmp(reg->volume, tic_tool_peek4(reg->waveform.data, data->phase) * SHRT_MAX / MAX_VOLUME * stereo_volume / MAX_VOLUME));
+        runWavetable(core, channel, voice, reg, period, points);
+    }
+    else
+    {
+        for (; data->time < ENDTIME; data->time += period, data->phase = (data->phase + 1) % WAVE_VALUES)
+        {
+            s32 value = tic_tool_peek4(reg->waveform.data, data->phase) * SHRT_MAX / MAX_VOLUME;
+
+            updateVoice(voice, data->time,
+                getAmp(reg->volume, value * voice->volume[0] / MAX_VOLUME),
+                getAmp(reg->volume, value * voice->volume[1] / MAX_VOLUME));
+        }
     }
 }
 
-static void runNoise(blip_buffer_t* blip, const tic_sound_register* reg, tic_sound_register_data* data, u8 stereo_volume)
+static void runNoise(StereoVoice* voice, const tic_sound_register* reg)
 {
+    tic_sound_register_data* data = voice->data[0];
+
     // phase is noise LFSR, which must never be zero
     if (data->phase == 0)
         data->phase = 1;
@@ -135,9 +358,14 @@ static void runNoise(blip_buffer_t* blip, const tic_sound_register* reg, tic_sou
     s32 period = freq2period(tic_sound_register_get_freq(reg));
     s32 fb = *reg->waveform.data ? 0x14 : 0x12000;
 
+    s32 amp[2];
+    for(s32 side = 0; side < 2; side++)
+        amp[side] = getAmp(reg->volume, voice->volume[side] * SHRT_MAX / MAX_VOLUME);
+
     for (; data->time < ENDTIME; data->time += period, data->phase = ((data->phase & 1) * fb) ^ (data->phase >> 1))
     {
-        update_amp(blip, data, getAmp(reg->volume, (data->phase & 1) ? stereo_volume * SHRT_MAX / MAX_VOLUME : 0));
+        s32 on = data->phase & 1;
+        updateVoice(voice, data->time, on ? amp[0] : 0, on ? amp[1] : 0);
     }
 }
 
@@ -505,38 +733,154 @@ void tic_api_music(tic_mem* memory, s32 index, s32 frame, s32 row, bool loop, bo
         memory->ram->music_state.flag.music_status = tic_music_play;
 }
 
+// the position processMusic moves to on its next call, if that starts a new row
+static bool nextMusicRow(tic_core* core, s32* frame, s32* row)
+{
+    const tic_music_state* music_state = &core->memory.ram->music_state;
+    const tic_track* track = &core->memory.ram->music.tracks.data[music_state->music.track];
+
+    *frame = music_state->music.frame;
+    *row = tick2row(core, track, core->state.music.ticks);
+
+    if (*row == music_state->music.row)
+        return false;
+
+    if (core->state.music.jump.active)
+    {
+        *frame = core->state.music.jump.frame;
+        *row = core->state.music.jump.beat * NOTES_PER_BEAT;
+    }
+
+    if (*row >= MUSIC_PATTERN_ROWS - track->rows)
+    {
+        *row = 0;
+
+        if (music_state->flag.music_status == tic_music_play)
+            *frame = (*frame + 1) % MUSIC_FRAMES;
+    }
+
+    return true;
+}
+
+// starts the track from the beginning and runs only the sequencer until frame/row is
+// reached, so tempo, volume and effect commands before it are in effect without
+// synthesizing the skipped part; returns the ticks skipped or -1 if it's never reached
+s32 tic_core_music_seek(tic_mem* memory, s32 index, s32 frame, s32 row, bool loop, bool sustain, s32 tempo, s32 speed)
+{
+    enum {MaxTicks = TIC80_FRAMERATE * 60 * 60};
+
+    tic_core* core = (tic_core*)memory;
+    tic_ram* ram = memory->ram;
+
+    frame = MAX(frame, 0);
+    row = MAX(row, 0);
+
+    tic_api_music(memory, index, 0, -1, loop, sustain, tempo, speed);
+
+    // the registers of the current tick belong to the caller
+    tic_sound_register registers[TIC_SOUND_CHANNELS];
+    tic_stereo_volume stereo = ram->stereo;
+    memcpy(registers, ram->registers, sizeof registers);
+
+    s32 ticks = 0;
+    for (; ticks < MaxTicks && ram->music_state.flag.music_status != tic_music_stop; ticks++)
+    {
+        s32 f, r;
+        if (nextMusicRow(core, &f, &r) && f == frame && r == row)
+            break;
+
+        processMusic(memory);
+    }
+
+    memcpy(ram->registers, registers, sizeof registers);
+    ram->stereo = stereo;
+
+    if (ticks == MaxTicks || ram->music_state.flag.music_status == tic_music_stop)
+    {
+        stopMusic(memory);
+        return -1;
+    }
+
+    return ticks;
+}
+
 void tic_api_sfx(tic_mem* memory, s32 index, s32 note, s32 octave, s32 duration, s32 channel, s32 left, s32 right, s32 speed)
 {
     tic_core* core = (tic_core*)memory;
     setSfxChannelData(memory, index, note, octave, duration, channel, left, right, speed);
 }
 
+void tic_api_stream(tic_mem* memory, s32 offset, s32 length, bool loop, s32 rate, s32 volume)
+{
+    tic_core* core = (tic_core*)memory;
+    tic_stream_register* stream = &core->state.stream;
+
+    stream->pos = 0;
+    stream->time = 0;
+
+    if(offset >= 0 && offset < TIC_BINARY_SIZE)
+    {
+        stream->offset = offset;
+        stream->length = length < 0 ? TIC_BINARY_SIZE - offset : MIN(length, TIC_BINARY_SIZE - offset);
+        stream->rate = CLAMP(rate, 1, TIC_STREAM_MAXRATE);
+        stream->volume = CLAMP(volume, 0, MAX_VOLUME);
+        stream->loop = loop;
+    }
+    else stream->length = 0;
+}
+
 static inline const struct sound_ring_buf *sound_ringbuf(tic_core* core)
 {
-    return &core->state.sound_ringbuf[(core->state.sound_ringbuf_tail + TIC_SOUND_RINGBUF_LEN - 1) % TIC_SOUND_RINGBUF_LEN];
+    return &core->sound_ringbuf[(core->sound_ringbuf_tail + TIC_SOUND_RINGBUF_LEN - 1) % TIC_SOUND_RINGBUF_LEN];
 }
 
-static void stereo_synthesize(tic_core* core, struct sound_register_data *regdata, blip_buffer_t* blip, u8 stereoRight)
+static void stereo_synthesize(tic_core* core, s32 points)
 {
     const struct sound_ring_buf *ringbuf = sound_ringbuf(core);
+    struct sound_register_data* left = &core->registers.left;
+    struct sound_register_data* right = &core->registers.right;
+    u32 head = core->audiotap.head;
 
     for (s32 i = 0; i < TIC_SOUND_CHANNELS; ++i)
     {
-        u8 stereo_volume = tic_tool_peek4(&ringbuf->stereo, stereoRight + i * 2);
-
         const tic_sound_register* reg = &ringbuf->registers[i];
-        tic_sound_register_data* data = &regdata->data[i];
+
+        StereoVoice voice =
+        {
+            {core->blip.left, core->blip.right},
+            {&left->data[i], &right->data[i]},
+            {tic_tool_peek4(&ringbuf->stereo, i * 2), tic_tool_peek4(&ringbuf->stereo, i * 2 + 1)},
+            {core->audiotap.data[i], head, points},
+        };
 
         tic_tool_noise(&reg->waveform)
-            ? runNoise(blip, reg, data, stereo_volume)
-            : runEnvelope(blip, reg, data, stereo_volume);
+            ? runNoise(&voice, reg)
+            : runEnvelope(core, i, &voice, reg, points);
+
+        tapVoice(&voice.tap, ENDTIME, left->data[i].amp, right->data[i].amp);
+
+        left->data[i].time -= ENDTIME;
+        right->data[i] = (tic_sound_register_data){left->data[i].time, left->data[i].phase, right->data[i].amp};
+    }
+
+    {
+        StereoVoice voice = {{core->blip.left, core->blip.right}, {&left->pcm, &right->pcm}, {0}, {core->audiotap.data[TIC_SOUND_CHANNELS], head, points}};
+        runPcm(&voice, &ringbuf->pcm);
+        tapVoice(&voice.tap, ENDTIME, left->pcm.amp, right->pcm.amp);
+        right->pcm = (tic_sound_register_data){left->pcm.time, left->pcm.phase, right->pcm.amp};
+    }
 
-        data->time -= ENDTIME;
+    {
+        AudioTap tap = {core->audiotap.data[TIC_SOUND_CHANNELS + 1], head, points};
+        runStream(core, &ringbuf->stream, &tap);
+        tapVoice(&tap, ENDTIME, core->registers.stream.amp[0], core->registers.stream.amp[1]);
     }
 
-    runPcm(blip, &ringbuf->pcm, &regdata->pcm);
+    // the taps are read from the script thread, publish the frame once it is complete
+    STORE_RELEASE(core->audiotap.head, head + points);
 
-    blip_end_frame(blip, ENDTIME);
+    blip_end_frame(core->blip.left, ENDTIME);
+    blip_end_frame(core->blip.right, ENDTIME);
 }
 
 void tic_core_synth_sound(tic_mem* memory)
@@ -544,20 +888,102 @@ void tic_core_synth_sound(tic_mem* memory)
     tic_core *core = (tic_core*)memory;
     tic80 *product = &core->memory.product;
 
+    // output samples per frame, 22050 Hz gives 367.5 so the fraction is carried
+    // over and every other frame is one sample longer to keep up with blip
+    s32 points = core->samplerate / TIC80_FRAMERATE;
+    core->samplecarry += core->samplerate % TIC80_FRAMERATE;
+
+    if(core->samplecarry >= TIC80_FRAMERATE)
+    {
+        core->samplecarry -= TIC80_FRAMERATE;
+        points++;
+    }
+
+    product->samples.count = points * TIC80_SAMPLE_CHANNELS;
+
     // synthesize sound using the register values found from the tail of the ring buffer
-    stereo_synthesize(core, &core->state.registers.left, core->blip.left, 0);
-    stereo_synthesize(core, &core->state.registers.right, core->blip.right, 1);
+    stereo_synthesize(core, points);
 
-    blip_read_samples(core->blip.left, product->samples.buffer, core->samplerate / TIC80_FRAMERATE, TIC80_SAMPLE_CHANNELS);
-    blip_read_samples(core->blip.right, product->samples.buffer + 1, core->samplerate / TIC80_FRAMERATE, TIC80_SAMPLE_CHANNELS);
+    blip_read_samples(core->blip.left, product->samples.buffer, points, TIC80_SAMPLE_CHANNELS);
+    blip_read_samples(core->blip.right, product->samples.buffer + 1, points, TIC80_SAMPLE_CHANNELS);
 
     // if the head has advanced, we can advance the tail too. Otherwise, we just
     // keep synthesizing audio using the last known register values, so at least we don't get crackles
-    if (core->state.sound_ringbuf_tail != core->state.sound_ringbuf_head) {
-        // note: we assume storing a 32 bit integer is atomic, that should hold on pretty much any modern processor
-        // assuming it is aligned in memory (which it should be)
-        core->state.sound_ringbuf_tail = (core->state.sound_ringbuf_tail + 1) % TIC_SOUND_RINGBUF_LEN;
+    // note: the tail is only written here and the head only in tic_core_sound_tick_end, which may run on
+    // another thread, so the ring buffer needs no lock; acquire/release orders the register snapshot
+    u32 tail = core->sound_ringbuf_tail;
+    s32 depth = (LOAD_ACQUIRE(core->sound_ringbuf_head) + TIC_SOUND_RINGBUF_LEN - tail) % TIC_SOUND_RINGBUF_LEN;
+    s32 average = core->latency.depth + (depth * 256 - core->latency.depth) / 16;
+
+    // a host draining several ticks per callback refills them between callbacks,
+    // so the queue swings by the burst size on top of the target
+    s32 limit = MIN(core->latency.target + core->latency.burst - 1, TIC_SOUND_RINGBUF_LEN - 2);
+
+    if (depth)
+    {
+        // the backlog stays above the target, e.g. after a stall on the producer side,
+        // drop a register frame to catch up instead of keeping the extra delay forever
+        if (depth > limit && average > limit * 256 + 128)
+        {
+            tail++;
+            average -= 256;
+        }
+
+        STORE_RELEASE(core->sound_ringbuf_tail, (tail + 1) % TIC_SOUND_RINGBUF_LEN);
     }
+
+    STORE_RELEASE(core->latency.depth, average);
+}
+
+void tic_core_sound_target(tic_mem* memory, s32 ticks)
+{
+    tic_core* core = (tic_core*)memory;
+    core->latency.target = CLAMP(ticks, 1, TIC_SOUND_RINGBUF_LEN - 2);
+}
+
+void tic_core_sound_burst(tic_mem* memory, s32 ticks)
+{
+    tic_core* core = (tic_core*)memory;
+    core->latency.burst = CLAMP(ticks, 1, TIC_SOUND_RINGBUF_LEN - 2);
+}
+
+// drops the queued register frames, so when every tick is followed by a synth call
+// each call plays the tick before it and the output stays frame aligned
+void tic_core_sound_flush(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    STORE_RELEASE(core->sound_ringbuf_tail, LOAD_ACQUIRE(core->sound_ringbuf_head));
+}
+
+// queued sound in output samples, not counting the host's device buffer
+s32 tic_core_sound_latency(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    return (s64)LOAD_ACQUIRE(core->latency.depth) * core->samplerate / (TIC80_FRAMERATE * 256);
+}
+
+// copies count samples of a voice ending offset samples before the newest one,
+// the synth may run ahead by a frame, so only the older half of the ring is readable
+s32 tic_core_audiotap(tic_mem* memory, s32 channel, s32 offset, s16* out, s32 count)
+{
+    tic_core* core = (tic_core*)memory;
+
+    if(channel < 0 || channel >= TIC_AUDIOTAP_CHANNELS || offset < 0 || count <= 0 || offset + count > TIC_AUDIOTAP_SIZE / 2)
+        return 0;
+
+    const s16* data = core->audiotap.data[channel];
+    u32 start = LOAD_ACQUIRE(core->audiotap.head) - offset - count;
+
+    for(s32 i = 0; i < count; i++)
+        out[i] = data[(start + i) % TIC_AUDIOTAP_SIZE];
+
+    return count;
+}
+
+double tic_api_audiotap(tic_mem* memory, s32 channel, s32 index)
+{
+    s16 value;
+    return tic_core_audiotap(memory, channel, index, &value, 1) ? (double)value / SHRT_MAX : 0;
 }
 
 void tic_core_sound_tick_start(tic_mem* memory)
@@ -580,19 +1006,60 @@ void tic_core_sound_tick_start(tic_mem* memory)
     }
 }
 
+// advances the stream() position by a tick and copies the samples it covers
+static void streamFrame(tic_core* core, struct sound_stream_frame* frame)
+{
+    tic_stream_register* reg = &core->state.stream;
+    const tic_binary* binary = &core->memory.cart.binary;
+    s32 size = MIN(reg->offset + reg->length, (s32)binary->size) - reg->offset;
+
+    frame->volume = reg->volume;
+    frame->count = 0;
+    frame->stop = false;
+
+    if(size <= 0 || (reg->pos >= size && !reg->loop))
+    {
+        frame->time = reg->time = 0;
+        frame->stop = true;
+        return;
+    }
+
+    frame->time = reg->time;
+    frame->period = (s32)(((s64)CLOCKRATE << 8) / reg->rate);
+
+    for(; reg->time < ENDTIME << 8 && frame->count < COUNT_OF(frame->data); reg->time += frame->period)
+    {
+        if(reg->pos >= size)
+        {
+            if(!reg->loop)
+            {
+                frame->stop = true;
+                reg->time = ENDTIME << 8;
+                break;
+            }
+
+            reg->pos = 0;
+        }
+
+        frame->data[frame->count++] = binary->data[reg->offset + reg->pos++];
+    }
+
+    reg->time -= ENDTIME << 8;
+}
+
 void tic_core_sound_tick_end(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
 
     // instead of synthesizing the sound right away, push the sound registers to the head of a ring buffer
-    struct sound_ring_buf *ringbuf = &core->state.sound_ringbuf[core->state.sound_ringbuf_head];
+    struct sound_ring_buf *ringbuf = &core->sound_ringbuf[core->sound_ringbuf_head];
     memcpy(&ringbuf->registers, &memory->ram->registers, sizeof ringbuf->registers);
     ringbuf->stereo = memory->ram->stereo;
     ringbuf->pcm = memory->ram->pcm;
+    streamFrame(core, &ringbuf->stream);
 
-    if (core->state.sound_ringbuf_head != (core->state.sound_ringbuf_tail + TIC_SOUND_RINGBUF_LEN - 2) % TIC_SOUND_RINGBUF_LEN) {
-        // note: we assume storing a 32 bit integer is atomic, that should hold on pretty much any modern processor
-        // assuming it is aligned in memory (which it should be)
-        core->state.sound_ringbuf_head = (core->state.sound_ringbuf_head + 1) % TIC_SOUND_RINGBUF_LEN;
+    // the slot before the tail is being synthesized, never write past it
+    if (core->sound_ringbuf_head != (LOAD_ACQUIRE(core->sound_ringbuf_tail) + TIC_SOUND_RINGBUF_LEN - 2) % TIC_SOUND_RINGBUF_LEN) {
+        STORE_RELEASE(core->sound_ringbuf_head, (core->sound_ringbuf_head + 1) % TIC_SOUND_RINGBUF_LEN);
     }
 }
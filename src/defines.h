@@ -44,6 +44,18 @@
 #define NEW(o)              (o*)malloc(sizeof(o))
 #define FREE(ptr)           do { if(ptr) free(ptr); } while (0)
 
+// 32-bit values shared between a single producer and a single consumer thread
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define LOAD_ACQUIRE(v)     ((u32)_InterlockedOr((volatile long*)&(v), 0))
+#define STORE_RELEASE(v, x) _InterlockedExchange((volatile long*)&(v), (long)(x))
+#define EXCHANGE(v, x)      ((u32)_InterlockedExchange((volatile long*)&(v), (long)(x)))
+#else
+#define LOAD_ACQUIRE(v)     __atomic_load_n(&(v), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(v, x) __atomic_store_n(&(v), (x), __ATOMIC_RELEASE)
+#define EXCHANGE(v, x)      __atomic_exchange_n(&(v), (x), __ATOMIC_ACQ_REL)
+#endif
+
 #define BITSET(a,b)         ((a) | (1ULL<<(b)))
 #define BITCLEAR(a,b)       ((a) & ~(1ULL<<(b)))
 #define BITFLIP(a,b)        ((a) ^ (1ULL<<(b)))
@@ -1,4 +1,7 @@
 
+#define _USE_MATH_DEFINES
+#include <math.h>
+
 #include "api.h"
 #ifndef TIC80_FFT_UNSUPPORTED
 // #define MA_DEBUG_OUTPUT
@@ -8,6 +11,11 @@
 #include "miniaudio.h"
 #include "../fftdata.h"
 #include "fft.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FFT_SSE
+#include <xmmintrin.h>
+#endif
 #endif
 #include <memory.h>
 #include <stdio.h>
@@ -19,7 +27,59 @@
 kiss_fftr_cfg fftcfg;
 ma_context context;
 ma_device captureDevice;
-float sampleBuf[FFT_SIZE * 2];
+
+// prefix sums of fftData and fftSmoothingData, a range query is a single subtraction
+static double fftDataSum[FFT_MAXSIZE + 1];
+static double fftSmoothingDataSum[FFT_MAXSIZE + 1];
+
+typedef struct
+{
+    float peak;
+    float data[FFT_MAXSIZE];
+} Spectrum;
+
+// the capture thread transforms every 'hop' samples and publishes finished spectra
+// through a lock-free triple buffer, the main thread only picks up the latest one
+#define SPECTRUM_INDEX 3
+#define SPECTRUM_FRESH 4
+
+static struct
+{
+    s32 length;     // transform length, 2 * fftSize
+    s32 hop;
+    s32 pos;        // write position in ring
+    s32 pending;    // samples since the last transform
+
+    float* ring;
+    float* window;
+    float* input;
+    kiss_fft_cpx* output;
+
+    Spectrum spectra[3];
+    s32 back;       // capture thread
+    u32 middle;     // shared, index | SPECTRUM_FRESH
+    s32 front;      // main thread
+} analysis;
+
+static float getMagnitudes(const kiss_fft_cpx* in, float* out, s32 count);
+
+static void analyze()
+{
+    // unroll the ring oldest first
+    const float* ring = analysis.ring;
+    const float* window = analysis.window;
+    float* input = analysis.input;
+    s32 length = analysis.length, pos = analysis.pos;
+
+    for (s32 i = 0, j = pos; i < length; i++, j = j + 1 < length ? j + 1 : 0)
+        input[i] = window ? ring[j] * window[i] : ring[j];
+
+    kiss_fftr(fftcfg, input, analysis.output);
+
+    Spectrum* spectrum = &analysis.spectra[analysis.back];
+    spectrum->peak = getMagnitudes(analysis.output, spectrum->data, fftSize);
+    analysis.back = EXCHANGE(analysis.middle, analysis.back | SPECTRUM_FRESH) & SPECTRUM_INDEX;
+}
 
 void miniaudioLogCallback(void* userData, ma_uint32 level, const char* message)
 {
@@ -47,19 +107,89 @@ void miniaudioLogCallback(void* userData, ma_uint32 level, const char* message)
 
 void OnReceiveFrames(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount)
 {
-    frameCount = frameCount < FFT_SIZE * 2 ? frameCount : FFT_SIZE * 2;
-
-    // Just rotate the buffer; copy existing, append new
     const float* samples = (const float*)pInput;
-    float* p = sampleBuf;
-    for (int i = 0; i < FFT_SIZE * 2 - frameCount; i++)
+    for (ma_uint32 i = 0; i < frameCount; i++)
+    {
+        analysis.ring[analysis.pos] = (samples[i * 2] + samples[i * 2 + 1]) / 2.0f;
+
+        if (++analysis.pos == analysis.length)
+            analysis.pos = 0;
+
+        if (++analysis.pending >= analysis.hop)
+        {
+            analysis.pending = 0;
+            analyze();
+        }
+    }
+}
+
+static float* createWindow(const char* name, s32 length)
+{
+    enum {WindowHann, WindowBlackman} type;
+
+    if (!name || !*name || strcmp(name, "none") == 0)
+        return NULL;
+    else if (strcmp(name, "hann") == 0)
+        type = WindowHann;
+    else if (strcmp(name, "blackman") == 0)
+        type = WindowBlackman;
+    else
     {
-        *(p++) = sampleBuf[i + frameCount];
+        FFT_DebugLog(FFT_LOG_WARNING, "Unknown window '%s', using none\n", name);
+        return NULL;
     }
-    for (int i = 0; i < frameCount; i++)
+
+    float* window = malloc(sizeof(float) * length);
+    double sum = 0;
+
+    for (s32 i = 0; i < length; i++)
     {
-        *(p++) = (samples[i * 2] + samples[i * 2 + 1]) / 2.0f;
+        double x = 2.0 * M_PI * i / length;
+        window[i] = type == WindowHann
+            ? 0.5 - 0.5 * cos(x)
+            : 0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x);
+        sum += window[i];
     }
+
+    // unit average gain keeps the levels close to the unwindowed ones
+    for (s32 i = 0; i < length; i++)
+        window[i] *= length / sum;
+
+    return window;
+}
+
+static void closeAnalysis()
+{
+    FREE(analysis.ring);
+    FREE(analysis.window);
+    FREE(analysis.input);
+    FREE(analysis.output);
+    ZEROMEM(analysis);
+}
+
+static void openAnalysis(const FFT_Settings* settings)
+{
+    closeAnalysis();
+
+    s32 size = settings && settings->size > 0 ? settings->size : FFT_SIZE;
+    size = CLAMP(size, FFT_MINSIZE, FFT_MAXSIZE);
+
+    // round up to a power of two
+    s32 bins = FFT_MINSIZE;
+    while (bins < size) bins <<= 1;
+
+    fftSize = bins;
+    analysis.length = bins * 2;
+    analysis.hop = settings && settings->hop > 0 ? settings->hop : bins / 2;
+    analysis.ring = calloc(analysis.length, sizeof(float));
+    analysis.window = createWindow(settings ? settings->window : NULL, analysis.length);
+    analysis.input = calloc(analysis.length, sizeof(float));
+    analysis.output = calloc(bins + 1, sizeof(kiss_fft_cpx));
+    analysis.back = 0;
+    analysis.middle = 1;
+    analysis.front = 2;
+
+    FFT_DebugLog(FFT_LOG_INFO, "FFT size %d, hop %d, window %s\n", fftSize, analysis.hop, analysis.window ? settings->window : "none");
 }
 
 void print_device_id(ma_device_id id, ma_backend backend)
@@ -178,15 +308,15 @@ void FFT_EnumerateDevices()
 #endif
 }
 
-bool FFT_Open(bool CapturePlaybackDevices, const char* CaptureDeviceSearchString)
+bool FFT_Open(bool CapturePlaybackDevices, const char* CaptureDeviceSearchString, const FFT_Settings* Settings)
 {
 #ifdef TIC80_FFT_UNSUPPORTED
     return true;
 #else
 
-    memset(sampleBuf, 0, sizeof(float) * FFT_SIZE * 2);
+    openAnalysis(Settings);
 
-    fftcfg = kiss_fftr_alloc(FFT_SIZE * 2, false, NULL, NULL);
+    fftcfg = kiss_fftr_alloc(analysis.length, false, NULL, NULL);
 
     ma_context_config context_config = ma_context_config_init();
     ma_log log;
@@ -315,27 +445,68 @@ void FFT_Close()
     ma_device_uninit(&captureDevice);
     ma_context_uninit(&context);
     kiss_fft_free(fftcfg);
+    closeAnalysis();
     fftEnabled = false;
 #endif
 }
 
 //////////////////////////////////////////////////////////////////////////
 
+#ifndef TIC80_FFT_UNSUPPORTED
+// magnitudes of the first count bins, returns the largest one
+static float getMagnitudes(const kiss_fft_cpx* in, float* out, s32 count)
+{
+    int i = 0;
+    float peak = 0.0f;
+
+#if defined(FFT_SSE)
+    // 4 bins per step, the interleaved re/im pairs are split with shuffles
+    __m128 max = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(&in[i].r);
+        __m128 b = _mm_loadu_ps(&in[i + 2].r);
+        a = _mm_mul_ps(a, a);
+        b = _mm_mul_ps(b, b);
+
+        __m128 power = _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        __m128 val = _mm_mul_ps(_mm_set1_ps(2.0f), _mm_sqrt_ps(power));
+
+        max = _mm_max_ps(max, val);
+        _mm_storeu_ps(out + i, val);
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, max);
+    peak = MAX(MAX(lanes[0], lanes[1]), MAX(lanes[2], lanes[3]));
+#endif
+
+    for (; i < count; i++)
+    {
+        out[i] = 2.0f * sqrtf(in[i].r * in[i].r + in[i].i * in[i].i);
+        peak = MAX(peak, out[i]);
+    }
+
+    return peak;
+}
+#endif
+
 void FFT_GetFFT(float* _samples)
 {
 #ifdef TIC80_FFT_UNSUPPORTED
     return;
 #else
 
-    kiss_fft_cpx out[FFT_SIZE + 1];
-    kiss_fftr(fftcfg, sampleBuf, out);
+    // take the newest finished spectrum, keep the current one if nothing arrived since
+    if (LOAD_ACQUIRE(analysis.middle) & SPECTRUM_FRESH)
+        analysis.front = EXCHANGE(analysis.middle, analysis.front) & SPECTRUM_INDEX;
 
-    float peakValue = fPeakMinValue;
-    for (int i = 0; i < FFT_SIZE; i++)
+    const Spectrum* spectrum = &analysis.spectra[analysis.front];
+
+    float peakValue = MAX(fPeakMinValue, spectrum->peak);
+    for (int i = 0; i < fftSize; i++)
     {
-        float val = 2.0f * sqrtf(out[i].r * out[i].r + out[i].i * out[i].i);
-        if (val > peakValue) peakValue = val;
-        _samples[i] = val * fAmplification;
+        _samples[i] = spectrum->data[i] * fAmplification;
     }
     if (peakValue > fPeakSmoothValue)
     {
@@ -348,7 +519,7 @@ void FFT_GetFFT(float* _samples)
     fAmplification = 1.0f / fPeakSmoothValue;
 
     float fFFTSmoothingFactor = 0.6f;
-    for (int i = 0; i < FFT_SIZE; i++)
+    for (int i = 0; i < fftSize; i++)
     {
         fftSmoothingData[i] = fftSmoothingData[i] * fFFTSmoothingFactor + (1 - fFFTSmoothingFactor) * _samples[i];
     }
@@ -370,9 +541,23 @@ double fft(s32 startFreq, s32 endFreq, bool smoothing)
         return 0.0;
     }
 
+    // carts that never call fft() don't pay for the transform
+    if (fftDirty)
+    {
+        FFT_GetFFT(fftData);
+
+        for (int i = 0; i < fftSize; i++)
+        {
+            fftDataSum[i + 1] = fftDataSum[i] + fftData[i];
+            fftSmoothingDataSum[i + 1] = fftSmoothingDataSum[i] + fftSmoothingData[i];
+        }
+
+        fftDirty = false;
+    }
+
     if (endFreq == -1)
     {
-        if (startFreq < 0 || startFreq >= FFT_SIZE)
+        if (startFreq < 0 || startFreq >= fftSize)
         {
             FFT_DebugLog(FFT_LOG_TRACE, "FFT: freq out of bounds at %d\n", startFreq);
             return 0.0;
@@ -381,7 +566,7 @@ double fft(s32 startFreq, s32 endFreq, bool smoothing)
     }
     else
     {
-        if ((startFreq < 0 && endFreq < 0) || (startFreq >= FFT_SIZE && endFreq >= FFT_SIZE))
+        if ((startFreq < 0 && endFreq < 0) || (startFreq >= fftSize && endFreq >= fftSize))
         {
             FFT_DebugLog(FFT_LOG_TRACE, "FFT: both startFreq and endFreq out of bounds, startFreq %d, endFreq %d\n", startFreq, endFreq);
             return 0.0;
@@ -393,16 +578,16 @@ double fft(s32 startFreq, s32 endFreq, bool smoothing)
             startFreq = 0;
         }
 
-        if (startFreq >= FFT_SIZE)
+        if (startFreq >= fftSize)
         {
-            FFT_DebugLog(FFT_LOG_TRACE, "FFT: clamped startFreq to %d\n", FFT_SIZE - 1);
+            FFT_DebugLog(FFT_LOG_TRACE, "FFT: clamped startFreq to %d\n", fftSize - 1);
             startFreq = 0;
         }
 
-        if (endFreq >= FFT_SIZE)
+        if (endFreq >= fftSize)
         {
-            FFT_DebugLog(FFT_LOG_TRACE, "FFT: clamped endFreq to %d\n", FFT_SIZE - 1);
-            endFreq = FFT_SIZE - 1;
+            FFT_DebugLog(FFT_LOG_TRACE, "FFT: clamped endFreq to %d\n", fftSize - 1);
+            endFreq = fftSize - 1;
         }
 
         if (startFreq > endFreq)
@@ -411,12 +596,8 @@ double fft(s32 startFreq, s32 endFreq, bool smoothing)
             endFreq = startFreq;
         }
 
-        double sum = 0.0;
-        for (int i = startFreq; i <= endFreq; i++)
-        {
-            sum += smoothing ? fftSmoothingData[i] : fftData[i];
-        }
-        return sum;
+        const double* sum = smoothing ? fftSmoothingDataSum : fftDataSum;
+        return sum[endFreq + 1] - sum[startFreq];
     }
 #endif
 }
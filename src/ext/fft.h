@@ -3,7 +3,14 @@
 
 //////////////////////////////////////////////////////////////////////////
 
-bool FFT_Open(bool CapturePlaybackDevices, const char* CaptureDeviceSearchString);
+typedef struct
+{
+    int size;           // bins, power of two in FFT_MINSIZE..FFT_MAXSIZE (0 - FFT_SIZE)
+    int hop;            // captured samples between transforms (0 - size / 2)
+    const char* window; // none, hann or blackman (NULL - none)
+} FFT_Settings;
+
+bool FFT_Open(bool CapturePlaybackDevices, const char* CaptureDeviceSearchString, const FFT_Settings* Settings);
 void FFT_EnumerateDevices();
 void FFT_GetFFT(float* _samples);
 void FFT_Close();
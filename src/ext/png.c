@@ -50,49 +50,77 @@ static void pngReadCallback(png_structp png, png_bytep out, png_size_t size)
     stream->pos += size;
 }
 
-png_img png_read(png_buffer buf, png_buffer *cart)
+typedef struct
 {
-    png_img res = { 0 };
+    png_structp png;
+    png_infop info;
+    PngStream stream;
+} PngReader;
 
-    if (png_sig_cmp(buf.data, 0, 8) == 0)
-    {
-        png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-        png_infop info = png_create_info_struct(png);
+// reads the header and sets up 8bit RGBA output
+static bool openReader(PngReader* reader, png_buffer buf, png_img* img)
+{
+    if (png_sig_cmp(buf.data, 0, 8) != 0)
+        return false;
 
-        PngStream stream = { .buffer = buf};
+    png_structp png = reader->png = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_infop info = reader->info = png_create_info_struct(png);
 
-        png_set_read_fn(png, &stream, pngReadCallback);
-        png_read_info(png, info);
+    reader->stream = (PngStream){ .buffer = buf};
 
-        res.width = png_get_image_width(png, info);
-        res.height = png_get_image_height(png, info);
-        s32 colorType = png_get_color_type(png, info);
-        s32 bitDepth = png_get_bit_depth(png, info);
+    png_set_read_fn(png, &reader->stream, pngReadCallback);
+    png_read_info(png, info);
 
-        if (bitDepth == 16)
-            png_set_strip_16(png);
+    img->width = png_get_image_width(png, info);
+    img->height = png_get_image_height(png, info);
+    s32 colorType = png_get_color_type(png, info);
+    s32 bitDepth = png_get_bit_depth(png, info);
 
-        if (colorType == PNG_COLOR_TYPE_PALETTE)
-            png_set_palette_to_rgb(png);
+    if (bitDepth == 16)
+        png_set_strip_16(png);
 
-        // PNG_COLOR_TYPE_GRAY_ALPHA is always 8 or 16bit depth.
-        if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
-            png_set_expand_gray_1_2_4_to_8(png);
+    if (colorType == PNG_COLOR_TYPE_PALETTE)
+        png_set_palette_to_rgb(png);
 
-        if (png_get_valid(png, info, PNG_INFO_tRNS))
-            png_set_tRNS_to_alpha(png);
+    // PNG_COLOR_TYPE_GRAY_ALPHA is always 8 or 16bit depth.
+    if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+        png_set_expand_gray_1_2_4_to_8(png);
 
-        // These colorType don't have an alpha channel then fill it with 0xff.
-        if (colorType == PNG_COLOR_TYPE_RGB ||
-            colorType == PNG_COLOR_TYPE_GRAY ||
-            colorType == PNG_COLOR_TYPE_PALETTE)
-            png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
+    if (png_get_valid(png, info, PNG_INFO_tRNS))
+        png_set_tRNS_to_alpha(png);
 
-        if (colorType == PNG_COLOR_TYPE_GRAY ||
-            colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
-            png_set_gray_to_rgb(png);
+    // These colorType don't have an alpha channel then fill it with 0xff.
+    if (colorType == PNG_COLOR_TYPE_RGB ||
+        colorType == PNG_COLOR_TYPE_GRAY ||
+        colorType == PNG_COLOR_TYPE_PALETTE)
+        png_set_filler(png, 0xFF, PNG_FILLER_AFTER);
 
-        png_read_update_info(png, info);
+    if (colorType == PNG_COLOR_TYPE_GRAY ||
+        colorType == PNG_COLOR_TYPE_GRAY_ALPHA)
+        png_set_gray_to_rgb(png);
+
+    // interlaced images are deinterlaced by png_read_image
+    png_set_interlace_handling(png);
+
+    png_read_update_info(png, info);
+
+    return true;
+}
+
+static void closeReader(PngReader* reader)
+{
+    png_destroy_read_struct(&reader->png, &reader->info, NULL);
+}
+
+png_img png_read(png_buffer buf, png_buffer *cart)
+{
+    png_img res = { 0 };
+    PngReader reader;
+
+    if (openReader(&reader, buf, &res))
+    {
+        png_structp png = reader.png;
+        png_infop info = reader.info;
 
         res.data = malloc(RGBA_SIZE * res.width * res.height);
         png_bytep* rows = (png_bytep*)malloc(sizeof(png_bytep) * res.height);
@@ -126,7 +154,7 @@ png_img png_read(png_buffer buf, png_buffer *cart)
                 }
         }
 
-        png_destroy_read_struct(&png, &info, NULL);
+        closeReader(&reader);
     }
 
     return res;
@@ -252,44 +280,159 @@ png_buffer png_encode(png_buffer cover, png_buffer cart)
     return out;
 }
 
-png_buffer png_decode(png_buffer cover)
+static inline u32 readBE32(const u8* ptr)
 {
-    png_buffer cart = { 0 };
-    png_img png = png_read(cover, &cart);
+    return (u32)ptr[0] << 24 | (u32)ptr[1] << 16 | (u32)ptr[2] << 8 | ptr[3];
+}
 
-    // if we have a data from a png chunk, use that
-    if (cart.data && cart.size > 0)
+// walks the chunk list and copies the cart chunk, the image data is skipped
+static png_buffer readCartChunk(png_buffer buf)
+{
+    enum {Signature = 8, Length = 4, Type = 4, Crc = 4};
+
+    if (buf.size < Signature || png_sig_cmp(buf.data, 0, Signature) != 0)
+        return (png_buffer) { 0 };
+
+    const u8* ptr = buf.data + Signature;
+    const u8* end = buf.data + buf.size;
+
+    while (end - ptr >= Length + Type + Crc)
     {
-        if (png.data)
-            free(png.data);
-        return cart;
+        u32 size = readBE32(ptr);
+        const u8* type = ptr + Length;
+        const u8* data = type + Type;
+
+        if (size > (u32)(end - data - Crc))
+            break;
+
+        // libpng only warns about a bad CRC of an unknown chunk and keeps it, so the CRC isn't checked
+        if (!memcmp(type, EXTRA_CHUNK, Type))
+        {
+            if (size == 0)
+                break;
+
+            png_buffer cart = png_create(size);
+
+            if (cart.data)
+                memcpy(cart.data, data, size);
+            else
+                cart.size = 0;
+
+            return cart;
+        }
+
+        if (!memcmp(type, "IEND", Type))
+            break;
+
+        ptr = data + size + Crc;
     }
 
-    // otherwise fallback to steganography
-    if (png.data)
+    return (png_buffer) { 0 };
+}
+
+typedef struct
+{
+    Header header;
+    png_buffer out;
+    s32 pixels;
+    s32 pos;
+    s32 end;
+    bool error;
+} Stego;
+
+// takes the next bytes of the RGBA stream, returns false when nothing more is needed
+static bool readStego(Stego* stego, const u8* data, s32 size)
+{
+    for (s32 i = 0; i < size && stego->pos < stego->end; i++, stego->pos++)
     {
-        Header header;
+        if (stego->pos < HEADER_SIZE)
+        {
+            bitcpy(stego->header.data, stego->pos * HEADER_BITS, data, i << 3, HEADER_BITS);
 
-        for (s32 i = 0; i < HEADER_SIZE; i++)
-            bitcpy(header.data, i * HEADER_BITS, png.data, i << 3, HEADER_BITS);
+            if (stego->pos == HEADER_SIZE - 1)
+            {
+                const Header* header = &stego->header;
 
-        if (header.bits > 0 
-            && header.bits <= BITS_IN_BYTE 
-            && header.size > 0 
-            && header.size <= png.width * png.height * RGBA_SIZE * header.bits / BITS_IN_BYTE - HEADER_SIZE)
+                if (header->bits > 0
+                    && header->bits <= BITS_IN_BYTE
+                    && header->size > 0
+                    && header->size <= stego->pixels * RGBA_SIZE * header->bits / BITS_IN_BYTE - HEADER_SIZE)
+                {
+                    s32 aligned = header->size + ceildiv(header->size * BITS_IN_BYTE % header->bits, BITS_IN_BYTE);
+                    stego->out = (png_buffer){ malloc(aligned), header->size };
+                    stego->end = HEADER_SIZE + ceildiv(header->size * BITS_IN_BYTE, header->bits);
+                }
+                else
+                {
+                    stego->error = true;
+                    return false;
+                }
+            }
+        }
+        else
+            bitcpy(stego->out.data, (stego->pos - HEADER_SIZE) * stego->header.bits, data, i << 3, stego->header.bits);
+    }
+
+    return stego->pos < stego->end;
+}
+
+png_buffer png_decode(png_buffer cover)
+{
+    // if we have a data from a png chunk, use that
+    png_buffer cart = readCartChunk(cover);
+
+    if (cart.data)
+        return cart;
+
+    // otherwise fallback to steganography, reading rows only until the cart is recovered
+    png_img img = { 0 };
+    PngReader reader;
+
+    if (!openReader(&reader, cover, &img))
+        return (png_buffer) { 0 };
+
+    Stego stego = {.pixels = img.width * img.height, .end = HEADER_SIZE};
+
+    bool interlaced = png_get_interlace_type(reader.png, reader.info) != PNG_INTERLACE_NONE;
+
+    if (!interlaced)
+    {
+        s32 rowSize = img.width * RGBA_SIZE;
+        u8* row = malloc(rowSize);
+
+        if (row)
         {
-            s32 aligned = header.size + ceildiv(header.size * BITS_IN_BYTE % header.bits, BITS_IN_BYTE);
-            png_buffer out = { malloc(aligned), header.size };
+            for (s32 y = 0; y < img.height; y++)
+            {
+                png_read_row(reader.png, row, NULL);
+
+                if (!readStego(&stego, row, rowSize))
+                    break;
+            }
 
-            const u8* from = png.data + HEADER_SIZE;
-            for (s32 i = 0, end = ceildiv(header.size * BITS_IN_BYTE, header.bits); i < end; i++)
-                bitcpy(out.data, i * header.bits, from, i << 3, header.bits);
+            free(row);
+        }
+    }
 
-            free(png.data);
+    closeReader(&reader);
 
-            return out;
+    // interlaced rows come in passes, so the whole image is needed
+    if (interlaced)
+    {
+        img = png_read(cover, NULL);
+
+        if (img.data)
+        {
+            readStego(&stego, img.data, stego.pixels * RGBA_SIZE);
+            free(img.data);
         }
     }
 
-    return (png_buffer) { 0 };
+    if (stego.error || stego.pos < stego.end)
+    {
+        free(stego.out.data);
+        return (png_buffer) { 0 };
+    }
+
+    return stego.out;
 }
@@ -1,16 +1,20 @@
 #pragma once
 #include <stdbool.h>
-#define FFT_SIZE 1024
+#define FFT_SIZE 1024       // default number of bins
+#define FFT_MINSIZE 256
+#define FFT_MAXSIZE 4096
 extern float fPeakMinValue;
 extern float fPeakSmoothing;
 extern float fPeakSmoothValue;
 extern float fAmplification;
-extern float fftData[FFT_SIZE];
-extern float fftSmoothingData[FFT_SIZE];
-extern float fftNormalizedData[FFT_SIZE];
-extern float fftNormalizedMaxData[FFT_SIZE];
+extern float fftData[FFT_MAXSIZE];
+extern float fftSmoothingData[FFT_MAXSIZE];
+extern float fftNormalizedData[FFT_MAXSIZE];
+extern float fftNormalizedMaxData[FFT_MAXSIZE];
 
+extern int fftSize; // bins in use, set by FFT_Open
 extern bool fftEnabled;
+extern bool fftDirty; // set every tick, the spectrum is computed on the first fft() call
 
 typedef enum
 {
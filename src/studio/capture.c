@@ -0,0 +1,175 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "capture.h"
+#include "render.h"
+#include "defines.h"
+#include "tools.h"
+#include "retro_endianness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPTURE_PIXELS (TIC80_FULLWIDTH * TIC80_FULLHEIGHT)
+
+struct tic_capture
+{
+    FILE* video;
+    FILE* audio;
+
+    bool y4m;
+    bool wav;
+
+    // byte offsets of the color components in a screen pixel
+    s32 r, g, b;
+
+    s32 samplerate;
+    u32 size;
+
+    u8 buffer[CAPTURE_PIXELS * 4];
+};
+
+tic_capture* tic_capture_open(const char* video, const char* audio, s32 samplerate, tic80_pixel_color_format format)
+{
+    tic_capture* capture = calloc(1, sizeof(tic_capture));
+
+    capture->samplerate = samplerate;
+
+    switch(format)
+    {
+    case TIC80_PIXEL_COLOR_BGRA8888: capture->r = 2; capture->g = 1; capture->b = 0; break;
+    case TIC80_PIXEL_COLOR_ABGR8888: capture->r = 3; capture->g = 2; capture->b = 1; break;
+    case TIC80_PIXEL_COLOR_ARGB8888: capture->r = 1; capture->g = 2; capture->b = 3; break;
+    default:                         capture->r = 0; capture->g = 1; capture->b = 2; break;
+    }
+
+    if(video)
+    {
+        capture->y4m = tic_tool_has_ext(video, ".y4m");
+
+        if(!(capture->video = fopen(video, "wb")))
+        {
+            tic_capture_close(capture);
+            return NULL;
+        }
+
+        if(capture->y4m)
+            fprintf(capture->video, "YUV4MPEG2 W%i H%i F%i:1 Ip A1:1 C444\n", TIC80_FULLWIDTH, TIC80_FULLHEIGHT, TIC80_FRAMERATE);
+    }
+
+    if(audio)
+    {
+        capture->wav = tic_tool_has_ext(audio, ".wav");
+
+        if(!(capture->audio = fopen(audio, "wb")))
+        {
+            tic_capture_close(capture);
+            return NULL;
+        }
+
+        // the sizes are patched on close, a pipe keeps the unknown length
+        if(capture->wav)
+            tic_render_wav_header(capture->audio, samplerate, 0xffffffff - 36);
+    }
+
+    return capture;
+}
+
+// BT.601 studio range, which is what players expect from Y4M without a color range tag
+static void writeY4M(tic_capture* capture, const u32* pixels)
+{
+    u8* y = capture->buffer;
+    u8* u = y + CAPTURE_PIXELS;
+    u8* v = u + CAPTURE_PIXELS;
+
+    for(s32 i = 0; i < CAPTURE_PIXELS; i++)
+    {
+        const u8* c = (const u8*)&pixels[i];
+        s32 r = c[capture->r], g = c[capture->g], b = c[capture->b];
+
+        y[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+        u[i] = (-38 * r - 74 * g + 112 * b + 32896) >> 8;
+        v[i] = (112 * r - 94 * g - 18 * b + 32896) >> 8;
+    }
+
+    fputs("FRAME\n", capture->video);
+    fwrite(capture->buffer, CAPTURE_PIXELS, 3, capture->video);
+}
+
+static void writeRGBA(tic_capture* capture, const u32* pixels)
+{
+    u8* dst = capture->buffer;
+
+    for(s32 i = 0; i < CAPTURE_PIXELS; i++)
+    {
+        const u8* c = (const u8*)&pixels[i];
+
+        *dst++ = c[capture->r];
+        *dst++ = c[capture->g];
+        *dst++ = c[capture->b];
+        *dst++ = 0xff;
+    }
+
+    fwrite(capture->buffer, CAPTURE_PIXELS, 4, capture->video);
+}
+
+void tic_capture_video(tic_capture* capture, const u32* pixels)
+{
+    if(capture->video)
+        capture->y4m
+            ? writeY4M(capture, pixels)
+            : writeRGBA(capture, pixels);
+}
+
+void tic_capture_audio(tic_capture* capture, const s16* samples, s32 count)
+{
+    if(capture->audio)
+    {
+#if RETRO_IS_BIG_ENDIAN
+        s16* buffer = (s16*)capture->buffer;
+
+        for(s32 i = 0; i < count; i++)
+            buffer[i] = retro_cpu_to_le16(samples[i]);
+
+        samples = buffer;
+#endif
+
+        capture->size += (u32)fwrite(samples, sizeof(s16), count, capture->audio) * sizeof(s16);
+    }
+}
+
+void tic_capture_close(tic_capture* capture)
+{
+    if(capture->video)
+        fclose(capture->video);
+
+    if(capture->audio)
+    {
+        if(capture->wav && fseek(capture->audio, 0, SEEK_SET) == 0)
+            tic_render_wav_header(capture->audio, capture->samplerate, capture->size);
+
+        fclose(capture->audio);
+    }
+
+    free(capture);
+}
@@ -0,0 +1,42 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "api.h"
+
+// streams every frame and its sound to files or named pipes for external encoders,
+// the video is raw RGBA or Y4M and the audio raw 16-bit stereo PCM or WAV, picked by the extension
+
+typedef struct tic_capture tic_capture;
+
+// either path can be NULL, returns NULL if a file can't be opened
+tic_capture* tic_capture_open(const char* video, const char* audio, s32 samplerate, tic80_pixel_color_format format);
+
+// a TIC80_FULLWIDTH x TIC80_FULLHEIGHT frame in the studio screen format
+void tic_capture_video(tic_capture* capture, const u32* pixels);
+
+// interleaved stereo samples, count includes both channels
+void tic_capture_audio(tic_capture* capture, const s16* samples, s32 count);
+
+void tic_capture_close(tic_capture* capture);
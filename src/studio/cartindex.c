@@ -0,0 +1,493 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "cartindex.h"
+#include "studio.h"
+#include "project.h"
+#include "fs.h"
+#include "thread.h"
+#include "defines.h"
+#include "tools.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CARTINDEX_QUEUE 16
+#define CARTINDEX_MAGIC 0x58444954 // TIDX
+#define CARTINDEX_VERSION 1
+
+// the cover is stored zipped as the palette followed by the 4bpp screen
+#define COVER_SIZE (sizeof(tic_palette) + sizeof(tic_screen))
+
+typedef struct
+{
+    char title[TIC_CARTINDEX_TEXT];
+    char author[TIC_CARTINDEX_TEXT];
+    char script[TIC_CARTINDEX_TEXT];
+} IndexMeta;
+
+typedef struct
+{
+    char* path;
+    u32 hash;
+    u64 date;
+    s32 size;
+    IndexMeta meta;
+
+    u8* cover;
+    s32 coverSize;
+
+    // the entry is up to date if it was checked in the current pass
+    u32 pass;
+    bool queued;
+} IndexEntry;
+
+typedef struct
+{
+    char path[TICNAME_MAX];
+    u64 date;
+    s32 size;
+    bool unchanged;
+    IndexMeta meta;
+
+    u8* cover;
+    s32 coverSize;
+} IndexJob;
+
+typedef struct
+{
+    u32 magic;
+    u32 version;
+    s32 count;
+} IndexHeader;
+
+typedef struct
+{
+    u64 date;
+    s32 size;
+    s32 pathSize;
+    s32 coverSize;
+    IndexMeta meta;
+} IndexRecord;
+
+struct tic_cartindex
+{
+    char path[TICNAME_MAX];
+    bool dirty;
+    u32 pass;
+
+    struct
+    {
+        IndexEntry* items;
+        s32 count;
+        s32 capacity;
+    } entries;
+
+    // jobs are queued at head, checked by the worker up to work
+    // and taken back by the main thread at tail
+    IndexJob jobs[CARTINDEX_QUEUE];
+    u32 head;
+    u32 work;
+    u32 tail;
+    u32 stop;
+
+    // scratch buffer of the worker
+    char* code;
+
+    u32 running;
+    tic_thread* thread;
+};
+
+static u32 hashPath(const char* path)
+{
+    u32 hash = 2166136261u;
+
+    while(*path)
+        hash = (hash ^ (u8)*path++) * 16777619u;
+
+    return hash;
+}
+
+static IndexEntry* findEntry(tic_cartindex* index, const char* path)
+{
+    u32 hash = hashPath(path);
+
+    for(IndexEntry *entry = index->entries.items, *end = entry + index->entries.count; entry < end; entry++)
+        if(entry->hash == hash && strcmp(entry->path, path) == 0)
+            return entry;
+
+    return NULL;
+}
+
+static IndexEntry* addEntry(tic_cartindex* index, const char* path)
+{
+    if(index->entries.count == index->entries.capacity)
+    {
+        index->entries.capacity = index->entries.capacity ? index->entries.capacity * 2 : 256;
+        index->entries.items = realloc(index->entries.items, index->entries.capacity * sizeof(IndexEntry));
+    }
+
+    IndexEntry* entry = &index->entries.items[index->entries.count++];
+    *entry = (IndexEntry){.path = strdup(path), .hash = hashPath(path)};
+
+    return entry;
+}
+
+static IndexEntry* getEntry(tic_cartindex* index, const char* path)
+{
+    IndexEntry* entry = findEntry(index, path);
+    return entry ? entry : addEntry(index, path);
+}
+
+static void readMeta(IndexMeta* meta, const char* code)
+{
+    tic_tool_metatag_copy(code, "title", NULL, meta->title, sizeof meta->title);
+    tic_tool_metatag_copy(code, "author", NULL, meta->author, sizeof meta->author);
+    tic_tool_metatag_copy(code, "script", NULL, meta->script, sizeof meta->script);
+}
+
+static void zipCover(IndexJob* job, const tic_palette* palette, const tic_screen* screen)
+{
+    u8 cover[COVER_SIZE];
+    memcpy(cover, palette, sizeof(tic_palette));
+    memcpy(cover + sizeof(tic_palette), screen, sizeof(tic_screen));
+
+    enum {Size = COVER_SIZE + COVER_SIZE / 100 + 64};
+
+    if((job->cover = malloc(Size)))
+        if(!(job->coverSize = tic_tool_zip(job->cover, Size, cover, COVER_SIZE)))
+            FREE(job->cover);
+}
+
+// runs on the worker, touches the file system and the job only
+static void checkCart(tic_cartindex* index, IndexJob* job)
+{
+    u64 date = fs_date(job->path);
+    s32 size = fs_size(job->path);
+
+    if(date == job->date && size == job->size)
+    {
+        job->unchanged = true;
+        return;
+    }
+
+    job->date = date;
+    job->size = size;
+
+    s32 dataSize = 0;
+    void* data = date ? fs_read(job->path, &dataSize) : NULL;
+
+    if(!data)
+        return;
+
+#if defined(TIC80_PRO)
+    if(project_ext(job->path))
+    {
+        tic_cartridge* cart = calloc(1, sizeof(tic_cartridge));
+
+        if(cart)
+        {
+            if(tic_project_load(job->path, data, dataSize, cart))
+            {
+                readMeta(&job->meta, cart->code.data);
+
+                if(!EMPTY(cart->bank0.screen.data) && !EMPTY(cart->bank0.palette.vbank0.data))
+                    zipCover(job, &cart->bank0.palette.vbank0, &cart->bank0.screen);
+            }
+
+            free(cart);
+        }
+    }
+    else
+#endif
+    {
+        tic_cart_view* view = tic_cart_view_open(data, dataSize);
+
+        if(view)
+        {
+            tic_palettes palette;
+            tic_screen screen;
+
+            if(tic_cart_view_code(view, index->code, TIC_CODE_SIZE + 1))
+                readMeta(&job->meta, index->code);
+
+            if(tic_cart_view_screen(view, 0, &screen) && tic_cart_view_palette(view, 0, &palette))
+                zipCover(job, &palette.vbank0, &screen);
+
+            tic_cart_view_close(view);
+        }
+    }
+
+    free(data);
+}
+
+// the worker exits when the queue is empty and is started again on demand
+static void indexLoop(void* data)
+{
+    tic_cartindex* index = data;
+    u32 work = index->work;
+
+    while(work != LOAD_ACQUIRE(index->head) && !LOAD_ACQUIRE(index->stop))
+    {
+        checkCart(index, &index->jobs[work % CARTINDEX_QUEUE]);
+        STORE_RELEASE(index->work, ++work);
+    }
+
+    STORE_RELEASE(index->running, 0);
+}
+
+static void joinWorker(tic_cartindex* index)
+{
+    tic_thread_join(index->thread);
+    index->thread = NULL;
+}
+
+static void runWorker(tic_cartindex* index)
+{
+    if(index->head != LOAD_ACQUIRE(index->work) && !LOAD_ACQUIRE(index->running) && !index->stop)
+    {
+        joinWorker(index);
+
+        // without the worker the queue is checked right here, which also clears running
+        STORE_RELEASE(index->running, 1);
+        index->thread = tic_thread_start(indexLoop, index);
+    }
+}
+
+static void loadIndex(tic_cartindex* index)
+{
+    s32 size = 0;
+    u8* data = fs_read(index->path, &size);
+
+    if(!data)
+        return;
+
+    const u8* ptr = data;
+    const u8* end = data + size;
+
+    IndexHeader header;
+    if(size >= (s32)sizeof header
+        && (memcpy(&header, ptr, sizeof header), header.magic == CARTINDEX_MAGIC && header.version == CARTINDEX_VERSION))
+    {
+        ptr += sizeof header;
+
+        for(s32 i = 0; i < header.count && end - ptr >= (s32)sizeof(IndexRecord); i++)
+        {
+            IndexRecord record;
+            memcpy(&record, ptr, sizeof record);
+            ptr += sizeof record;
+
+            if(record.pathSize <= 0 || record.pathSize >= TICNAME_MAX || record.coverSize < 0
+                || end - ptr < record.pathSize + record.coverSize)
+                break;
+
+            char path[TICNAME_MAX];
+            memcpy(path, ptr, record.pathSize);
+            path[record.pathSize] = '\0';
+            ptr += record.pathSize;
+
+            IndexEntry* entry = getEntry(index, path);
+            entry->date = record.date;
+            entry->size = record.size;
+            entry->meta = record.meta;
+
+            free(entry->cover);
+            entry->cover = NULL;
+            entry->coverSize = 0;
+
+            if(record.coverSize && (entry->cover = malloc(record.coverSize)))
+            {
+                memcpy(entry->cover, ptr, record.coverSize);
+                entry->coverSize = record.coverSize;
+            }
+
+            ptr += record.coverSize;
+        }
+    }
+
+    free(data);
+}
+
+tic_cartindex* tic_cartindex_open(const char* path)
+{
+    tic_cartindex* index = calloc(1, sizeof(tic_cartindex));
+
+    if(index)
+    {
+        strncpy(index->path, path, sizeof index->path - 1);
+        index->pass = 1;
+        index->code = malloc(TIC_CODE_SIZE + 1);
+        loadIndex(index);
+    }
+
+    return index;
+}
+
+void tic_cartindex_save(tic_cartindex* index)
+{
+    if(!index->dirty)
+        return;
+
+    IndexHeader header = {CARTINDEX_MAGIC, CARTINDEX_VERSION, 0};
+    s32 size = sizeof header;
+
+    // files which were gone at the last check are not kept
+    for(const IndexEntry *entry = index->entries.items, *end = entry + index->entries.count; entry < end; entry++)
+        if(entry->date)
+        {
+            size += sizeof(IndexRecord) + strlen(entry->path) + entry->coverSize;
+            header.count++;
+        }
+
+    u8* data = malloc(size);
+
+    if(data)
+    {
+        u8* ptr = data;
+        memcpy(ptr, &header, sizeof header);
+        ptr += sizeof header;
+
+        for(const IndexEntry *entry = index->entries.items, *end = entry + index->entries.count; entry < end; entry++)
+            if(entry->date)
+            {
+                IndexRecord record = {entry->date, entry->size, strlen(entry->path), entry->coverSize, entry->meta};
+                memcpy(ptr, &record, sizeof record);
+                ptr += sizeof record;
+                memcpy(ptr, entry->path, record.pathSize);
+                ptr += record.pathSize;
+                if(entry->cover)
+                    memcpy(ptr, entry->cover, entry->coverSize);
+                ptr += entry->coverSize;
+            }
+
+        if(fs_write(index->path, data, size))
+            index->dirty = false;
+
+        free(data);
+    }
+}
+
+void tic_cartindex_update(tic_cartindex* index)
+{
+    u32 work = LOAD_ACQUIRE(index->work);
+
+    for(; index->tail != work; index->tail++)
+    {
+        IndexJob* job = &index->jobs[index->tail % CARTINDEX_QUEUE];
+        IndexEntry* entry = getEntry(index, job->path);
+
+        entry->queued = false;
+        entry->pass = index->pass;
+
+        if(!job->unchanged)
+        {
+            free(entry->cover);
+            entry->cover = job->cover;
+            entry->coverSize = job->coverSize;
+            entry->date = job->date;
+            entry->size = job->size;
+            entry->meta = job->meta;
+            index->dirty = true;
+        }
+    }
+
+    runWorker(index);
+}
+
+void tic_cartindex_recheck(tic_cartindex* index)
+{
+    index->pass++;
+}
+
+bool tic_cartindex_request(tic_cartindex* index, const char* path)
+{
+    IndexEntry* entry = getEntry(index, path);
+
+    if(entry->pass == index->pass || entry->queued)
+        return true;
+
+    if(index->head - index->tail == CARTINDEX_QUEUE)
+        return false;
+
+    IndexJob* job = &index->jobs[index->head % CARTINDEX_QUEUE];
+    *job = (IndexJob){.date = entry->date, .size = entry->size};
+    strncpy(job->path, path, sizeof job->path - 1);
+
+    entry->queued = true;
+    STORE_RELEASE(index->head, index->head + 1);
+
+    runWorker(index);
+
+    return true;
+}
+
+bool tic_cartindex_find(tic_cartindex* index, const char* path, tic_cartindex_info* info)
+{
+    IndexEntry* entry = findEntry(index, path);
+
+    if(entry && entry->pass == index->pass)
+    {
+        u8 cover[COVER_SIZE];
+
+        memcpy(info->title, entry->meta.title, sizeof info->title);
+        memcpy(info->author, entry->meta.author, sizeof info->author);
+        memcpy(info->script, entry->meta.script, sizeof info->script);
+
+        info->cover = entry->cover && tic_tool_unzip(cover, COVER_SIZE, entry->cover, entry->coverSize) == COVER_SIZE;
+
+        if(info->cover)
+        {
+            memcpy(&info->palette, cover, sizeof(tic_palette));
+            memcpy(&info->screen, cover + sizeof(tic_palette), sizeof(tic_screen));
+        }
+
+        return true;
+    }
+
+    tic_cartindex_request(index, path);
+
+    return false;
+}
+
+void tic_cartindex_close(tic_cartindex* index)
+{
+    if(!index)
+        return;
+
+    STORE_RELEASE(index->stop, 1);
+    joinWorker(index);
+
+    // take the checked jobs, the rest are dropped and checked again next time
+    tic_cartindex_update(index);
+    tic_cartindex_save(index);
+
+    for(IndexEntry *entry = index->entries.items, *end = entry + index->entries.count; entry < end; entry++)
+    {
+        free(entry->path);
+        free(entry->cover);
+    }
+
+    free(index->entries.items);
+    free(index->code);
+    free(index);
+}
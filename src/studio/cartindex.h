@@ -0,0 +1,62 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "tic.h"
+
+// persistent index of cart metadata and covers for the surf browser,
+// entries are keyed by path, mtime and size and filled by a worker thread
+
+#define TIC_CARTINDEX_TEXT 64
+
+typedef struct tic_cartindex tic_cartindex;
+
+typedef struct
+{
+    char title[TIC_CARTINDEX_TEXT];
+    char author[TIC_CARTINDEX_TEXT];
+    char script[TIC_CARTINDEX_TEXT];
+
+    bool cover;
+    tic_palette palette;
+    tic_screen screen;
+} tic_cartindex_info;
+
+tic_cartindex*  tic_cartindex_open      (const char* path);
+
+// waits for the worker and saves the index if it changed
+void            tic_cartindex_close     (tic_cartindex* index);
+void            tic_cartindex_save      (tic_cartindex* index);
+
+// takes the worker results, call it every frame the index is used
+void            tic_cartindex_update    (tic_cartindex* index);
+
+// entries are checked against their files again on the next request
+void            tic_cartindex_recheck   (tic_cartindex* index);
+
+// queues the cart to be checked, returns false if the queue is full
+bool            tic_cartindex_request   (tic_cartindex* index, const char* path);
+
+// returns true once the cart has been checked in the current pass, otherwise queues it
+bool            tic_cartindex_find      (tic_cartindex* index, const char* path, tic_cartindex_info* info);
@@ -91,6 +91,9 @@ static void setDefault(Config* config)
             .crt            = false,
 #endif
             .volume         = MAX_VOLUME,
+            .samplerate     = 0,
+            .audioBuffer    = 0,
+            .audioLatency   = 0,
             .vsync          = DEFAULT_VSYNC,
             .fullscreen     = false,
             .integerScale   = INTEGER_SCALE_DEFAULT,
@@ -177,6 +180,9 @@ static void loadOptions(Config* config)
             options->vsync = json_bool("vsync", 0);
             options->integerScale = json_bool("integerScale", 0);
             options->volume = json_int("volume", 0);
+            options->samplerate = json_int("samplerate", 0);
+            options->audioBuffer = json_int("audioBuffer", 0);
+            options->audioLatency = json_int("audioLatency", 0);
             options->autosave = json_bool("autosave", 0);
 
             string mapping;
@@ -256,6 +262,9 @@ static void saveOptions(Config* config)
             "\"vsync\":%s, "
             "\"integerScale\":%s, "
             "\"volume\":%i, "
+            "\"samplerate\":%i, "
+            "\"audioBuffer\":%i, "
+            "\"audioLatency\":%i, "
             "\"autosave\":%s, "
             "\"mapping\":\"%s\""
 #if defined(BUILD_EDITORS)
@@ -273,6 +282,9 @@ static void saveOptions(Config* config)
         bool2str(options->vsync),
         bool2str(options->integerScale),
         options->volume,
+        options->samplerate,
+        options->audioBuffer,
+        options->audioLatency,
         bool2str(options->autosave),
         data2str(&options->mapping, sizeof options->mapping).data
 
@@ -592,7 +592,12 @@ static void playTrackFromNow(Music* music)
 {
     tic_mem* tic = music->tic;
 
-    tic_api_music(tic, music->track, music->frame, music->tab == MUSIC_TRACKER_TAB ? music->tracker.edit.y : -1, music->loop, music->sustain, -1, -1);
+    s32 row = music->tab == MUSIC_TRACKER_TAB ? music->tracker.edit.y : -1;
+
+    // run the sequencer up to the cursor so the commands before it are applied,
+    // positions it never gets to are started as is
+    if(tic_core_music_seek(tic, music->track, music->frame, row, music->loop, music->sustain, -1, -1) < 0)
+        tic_api_music(tic, music->track, music->frame, row, music->loop, music->sustain, -1, -1);
 }
 
 static void playFrame(Music* music)
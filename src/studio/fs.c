@@ -62,6 +62,15 @@
 #include <mach-o/dyld.h>
 #endif
 
+#if defined(__TIC_LINUX__) && !defined(__TIC_ANDROID__) && !defined(BAREMETALPI)
+#define FS_WATCH_INOTIFY
+#include <sys/inotify.h>
+#include <errno.h>
+#endif
+
+// poll() calls between two stat() passes for the polling backend
+#define FS_WATCH_POLL_PERIOD 15
+
 static const char* PublicDir = TIC_HOST;
 
 struct tic_fs
@@ -732,6 +741,220 @@ u64 fs_date(const char* path)
 #endif
 }
 
+s32 fs_size(const char* path)
+{
+#if defined(BAREMETALPI)
+    dbg("fs_size %s\n", path);
+    FILINFO fi;
+    FRESULT res = f_stat(path, &fi);
+    return res == FR_OK ? fi.fsize : 0;
+#else
+    struct tic_stat_struct s;
+
+    const FsString* pathString = utf8ToString(path);
+    s32 ret = tic_stat(pathString, &s);
+    freeString(pathString);
+
+    if(ret == 0 && S_ISREG(s.st_mode))
+    {
+        return (s32)s.st_size;
+    }
+
+    return 0;
+#endif
+}
+
+typedef struct
+{
+    char path[TICNAME_MAX];
+    u64 date;
+    s32 refs; // the same path can be added by --watch and by the loaded cart
+#if defined(FS_WATCH_INOTIFY)
+    s32 wd;
+    s32 name;
+#endif
+} WatchEntry;
+
+struct tic_fs_watch
+{
+    WatchEntry* items;
+    s32 count;
+    s32 ticks;
+#if defined(FS_WATCH_INOTIFY)
+    s32 fd;
+#endif
+};
+
+tic_fs_watch* tic_fs_watch_create()
+{
+    tic_fs_watch* watch = calloc(1, sizeof(tic_fs_watch));
+
+#if defined(FS_WATCH_INOTIFY)
+    watch->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+
+    return watch;
+}
+
+void tic_fs_watch_delete(tic_fs_watch* watch)
+{
+#if defined(FS_WATCH_INOTIFY)
+    if(watch->fd >= 0)
+        close(watch->fd);
+#endif
+
+    free(watch->items);
+    free(watch);
+}
+
+static WatchEntry* findWatch(tic_fs_watch* watch, const char* path)
+{
+    for(WatchEntry* it = watch->items, *end = it + watch->count; it != end; ++it)
+        if(strcmp(it->path, path) == 0)
+            return it;
+
+    return NULL;
+}
+
+void tic_fs_watch_add(tic_fs_watch* watch, const char* path)
+{
+    if(!*path)
+        return;
+
+    WatchEntry* found = findWatch(watch, path);
+
+    if(found)
+    {
+        found->refs++;
+        return;
+    }
+
+    watch->items = realloc(watch->items, sizeof(WatchEntry) * (watch->count + 1));
+    WatchEntry* entry = &watch->items[watch->count++];
+
+    ZEROMEM(*entry);
+    strncpy(entry->path, path, sizeof entry->path - 1);
+    entry->date = fs_date(path);
+    entry->refs = 1;
+
+#if defined(FS_WATCH_INOTIFY)
+    // watch the folder, editors usually save by renaming a temp file over the original
+    {
+        char dir[TICNAME_MAX];
+        strcpy(dir, entry->path);
+
+        char* slash = strrchr(dir, SLASH_SYMBOL);
+        entry->name = slash ? (s32)(slash - dir) + 1 : 0;
+
+        if(slash)
+            slash == dir ? (slash[1] = '\0') : (*slash = '\0');
+        else
+            strcpy(dir, ".");
+
+        entry->wd = watch->fd >= 0
+            ? inotify_add_watch(watch->fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO)
+            : -1;
+    }
+#endif
+}
+
+void tic_fs_watch_remove(tic_fs_watch* watch, const char* path)
+{
+    WatchEntry* entry = findWatch(watch, path);
+
+    if(!entry || --entry->refs > 0)
+        return;
+
+#if defined(FS_WATCH_INOTIFY)
+    if(entry->wd >= 0)
+    {
+        bool shared = false;
+
+        for(s32 i = 0; i < watch->count; i++)
+            if(&watch->items[i] != entry && watch->items[i].wd == entry->wd)
+                shared = true;
+
+        if(!shared)
+            inotify_rm_watch(watch->fd, entry->wd);
+    }
+#endif
+
+    *entry = watch->items[--watch->count];
+}
+
+static void pollWatchDates(tic_fs_watch* watch, fs_watch_callback callback, void* data)
+{
+    for(s32 i = 0; i < watch->count; i++)
+    {
+        WatchEntry* entry = &watch->items[i];
+        u64 date = fs_date(entry->path);
+
+        if(date != entry->date)
+        {
+            entry->date = date;
+
+            if(date && callback)
+                callback(entry->path, data);
+        }
+    }
+}
+
+void tic_fs_watch_poll(tic_fs_watch* watch, fs_watch_callback callback, void* data)
+{
+    if(!watch->count)
+        return;
+
+#if defined(FS_WATCH_INOTIFY)
+    if(watch->fd >= 0)
+    {
+        char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+        ssize_t size;
+
+        while((size = read(watch->fd, buf, sizeof buf)) > 0)
+        {
+            for(const char* ptr = buf; ptr < buf + size;)
+            {
+                const struct inotify_event* event = (const struct inotify_event*)ptr;
+                ptr += sizeof(struct inotify_event) + event->len;
+
+                if(event->len)
+                    for(s32 i = 0; i < watch->count; i++)
+                    {
+                        WatchEntry* entry = &watch->items[i];
+
+                        if(entry->wd == event->wd && strcmp(entry->path + entry->name, event->name) == 0)
+                        {
+                            entry->date = fs_date(entry->path);
+
+                            if(callback)
+                                callback(entry->path, data);
+                        }
+                    }
+            }
+        }
+
+        // watches that failed to register (missing folder) fall back to polling
+        bool polled = false;
+        for(s32 i = 0; i < watch->count; i++)
+            polled |= watch->items[i].wd < 0;
+
+        if(!polled)
+            return;
+    }
+#endif
+
+    if(watch->ticks++ % FS_WATCH_POLL_PERIOD == 0)
+        pollWatchDates(watch, callback, data);
+}
+
+void tic_fs_watch_skip(tic_fs_watch* watch)
+{
+    tic_fs_watch_poll(watch, NULL, NULL);
+
+    for(s32 i = 0; i < watch->count; i++)
+        watch->items[i].date = fs_date(watch->items[i].path);
+}
+
 bool tic_fs_save(tic_fs* fs, const char* name, const void* data, s32 size, bool overwrite)
 {
     if(!overwrite)
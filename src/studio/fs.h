@@ -29,8 +29,10 @@ typedef bool(*fs_list_callback)(const char* name, const char* title, const char*
 typedef void(*fs_done_callback)(void* data);
 typedef void(*fs_isdir_callback)(bool dir, void* data);
 typedef void(*fs_load_callback)(const u8* buffer, s32 size, void* data);
+typedef void(*fs_watch_callback)(const char* path, void* data);
 
 typedef struct tic_fs tic_fs;
+typedef struct tic_fs_watch tic_fs_watch;
 struct tic_net;
 
 tic_fs*     tic_fs_create   (const char* path, struct tic_net* net);
@@ -57,7 +59,17 @@ void    tic_fs_dir          (tic_fs* fs, char* out);
 void    tic_fs_dirback      (tic_fs* fs);
 void    tic_fs_homedir      (tic_fs* fs);
 
+// file change notifications, inotify on Linux and mtime polling elsewhere
+// a path added several times stays watched until it's removed as many times
+tic_fs_watch*   tic_fs_watch_create ();
+void            tic_fs_watch_delete (tic_fs_watch* watch);
+void            tic_fs_watch_add    (tic_fs_watch* watch, const char* path);
+void            tic_fs_watch_remove (tic_fs_watch* watch, const char* path);
+void            tic_fs_watch_poll   (tic_fs_watch* watch, fs_watch_callback callback, void* data);
+void            tic_fs_watch_skip   (tic_fs_watch* watch);
+
 u64     fs_date     (const char* name);
+s32     fs_size     (const char* name);
 bool    fs_exists   (const char* name);
 bool    fs_isdir    (const char* path);
 void*   fs_read     (const char* path, s32* size);
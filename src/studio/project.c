@@ -51,58 +51,75 @@ static void makeTag(const char* tag, char* out, s32 bank)
     else strcpy(out, tag);
 }
 
-static bool bufferEmpty(const u8* data, s32 size)
+// the same code measures the output when there is no buffer and writes it when there is one
+typedef struct
 {
-    for(s32 i = 0; i < size; i++)
-        if(*data++)
-            return false;
+    char* ptr;
+    s32 size;
+} ProjectWriter;
 
-    return true;
+static void writeText(ProjectWriter* writer, const char* text, s32 len)
+{
+    if(writer->ptr)
+        memcpy(writer->ptr + writer->size, text, len);
+
+    writer->size += len;
 }
 
-static char* saveTextSection(char* ptr, const char* data)
+static inline void writeString(ProjectWriter* writer, const char* str)
 {
-    if(data[0] == '\0')
-        return ptr;
+    writeText(writer, str, (s32)strlen(str));
+}
 
-    sprintf(ptr, "%s\n", data);
-    ptr += strlen(ptr);
+static void saveTextSection(ProjectWriter* writer, const char* data, s32 size)
+{
+    const char* end = memchr(data, '\0', size);
+    s32 len = end ? (s32)(end - data) : size;
 
-    return ptr;
+    if(len)
+    {
+        writeText(writer, data, len);
+        writeText(writer, "\n", 1);
+    }
 }
 
-static char* saveBinaryBuffer(char* ptr, const char* comment, const void* data, s32 size, s32 row, bool flip)
+static void saveBinaryBuffer(ProjectWriter* writer, const char* comment, const void* data, s32 size, s32 row, bool flip)
 {
-    if(bufferEmpty(data, size))
-        return ptr;
+    if(tic_tool_empty(data, size))
+        return;
 
-    sprintf(ptr, "%s %03i:", comment, row);
-    ptr += strlen(ptr);
+    char index[] = " 000:";
+    index[1] += row / 100 % 10;
+    index[2] += row / 10 % 10;
+    index[3] += row % 10;
 
-    tic_tool_buf2str(data, size, ptr, flip);
-    ptr += strlen(ptr);
+    writeString(writer, comment);
+    writeText(writer, index, sizeof index - 1);
 
-    sprintf(ptr, "\n");
-    ptr += strlen(ptr);
+    if(writer->ptr)
+        tic_tool_buf2str(data, size, writer->ptr + writer->size, flip);
 
-    return ptr;
+    writer->size += size * 2;
+    writeText(writer, "\n", 1);
 }
 
-static char* saveBinarySection(char* ptr, const char* comment, const char* tag, s32 count, const void* data, s32 size, bool flip)
+static void saveBinarySection(ProjectWriter* writer, const char* comment, const char* tag, s32 count, const void* data, s32 size, bool flip)
 {
-    if(bufferEmpty(data, size * count))
-        return ptr;
+    if(tic_tool_empty(data, size * count))
+        return;
 
-    sprintf(ptr, "%s <%s>\n", comment, tag);
-    ptr += strlen(ptr);
+    writeString(writer, comment);
+    writeText(writer, " <", 2);
+    writeString(writer, tag);
+    writeText(writer, ">\n", 2);
 
     for(s32 i = 0; i < count; i++, data = (u8*)data + size)
-        ptr = saveBinaryBuffer(ptr, comment, data, size, i, flip);
+        saveBinaryBuffer(writer, comment, data, size, i, flip);
 
-    sprintf(ptr, "%s </%s>\n\n", comment, tag);
-    ptr += strlen(ptr);
-
-    return ptr;
+    writeString(writer, comment);
+    writeText(writer, " </", 3);
+    writeString(writer, tag);
+    writeText(writer, ">\n\n", 3);
 }
 
 static const char* projectComment(const char* name)
@@ -116,52 +133,132 @@ static const char* projectComment(const char* name)
     return NULL;
 }
 
-s32 tic_project_save(const char* name, void* data, const tic_cartridge* cart)
+static void saveProject(ProjectWriter* writer, const char* name, const tic_cartridge* cart)
 {
     const char* comment = projectComment(name);
-    char* stream = data;
-    char* ptr = saveTextSection(stream, cart->code.data);
     char tag[16];
 
+    saveTextSection(writer, cart->code.data, sizeof cart->code.data);
+
     FOR(const struct BinarySection*, section, BinarySections)
         for(s32 b = 0; b < TIC_BANKS; b++)
         {
             makeTag(section->tag, tag, b);
 
-            ptr = saveBinarySection(ptr, comment, tag, section->count,
+            saveBinarySection(writer, comment, tag, section->count,
                 (u8*)&cart->banks[b] + section->offset, section->size, section->flip);
         }
 
     if(cart->lang)
-        ptr = saveBinarySection(ptr, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
+        saveBinarySection(writer, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
+}
 
-    return (s32)strlen(stream);
+s32 tic_project_size(const char* name, const tic_cartridge* cart)
+{
+    ProjectWriter writer = {NULL, 0};
+    saveProject(&writer, name, cart);
+
+    return writer.size;
 }
 
-static bool loadTextSection(const char* project, const char* comment, char* dst, s32 size)
+s32 tic_project_save(const char* name, void* data, const tic_cartridge* cart)
 {
-    bool done = false;
+    ProjectWriter writer = {data, 0};
+    saveProject(&writer, name, cart);
+    writer.ptr[writer.size] = '\0';
 
-    const char* start = project;
-    const char* end = project + strlen(project);
+    return writer.size;
+}
 
+// every "<comment> <" in the project with the tag name when it has one, found in one pass
+// so the sections are looked up in the index instead of searching the text again
+typedef struct
+{
+    const char* start;
+    const char* name; // NULL if there is no '>' on the line
+    s32 len;
+    bool close;
+} ProjectTag;
+
+typedef struct
+{
+    ProjectTag* items;
+    s32 count;
+    s32 capacity;
+} ProjectTags;
+
+static void indexTags(const char* project, const char* comment, ProjectTags* tags)
+{
+    char prefix[16];
+    sprintf(prefix, "%s <", comment);
+    size_t prefixLen = strlen(prefix);
+
+    for(const char* ptr = strstr(project, prefix); ptr; ptr = strstr(ptr + 1, prefix))
     {
-        char tagstart[16];
-        sprintf(tagstart, "\n%s <", comment);
+        const char* name = ptr + prefixLen;
+        bool close = *name == '/';
+        name += close;
 
-        const char* ptr = strstr(project, tagstart);
+        const char* end = name;
+        while(*end && *end != '>' && *end != '\n')
+            end++;
 
-        if(ptr && ptr < end)
-            end = ptr;
+        if(tags->count == tags->capacity)
+        {
+            tags->capacity = MAX(tags->capacity * 2, 64);
+            tags->items = realloc(tags->items, tags->capacity * sizeof(ProjectTag));
+        }
+
+        tags->items[tags->count++] = *end == '>'
+            ? (ProjectTag){ptr, name, (s32)(end - name), close}
+            : (ProjectTag){ptr};
     }
+}
+
+static bool tagIs(const ProjectTag* tag, const char* name)
+{
+    return tag->name && strncmp(tag->name, name, tag->len) == 0 && name[tag->len] == '\0';
+}
+
+// the first opening tag anywhere in the text
+static const ProjectTag* findOpenTag(const ProjectTags* tags, const char* name)
+{
+    for(const ProjectTag* tag = tags->items, *end = tag + tags->count; tag != end; tag++)
+        if(!tag->close && tagIs(tag, name))
+            return tag;
+
+    return NULL;
+}
+
+// the first closing tag which starts a line after the given position
+static const ProjectTag* findCloseTag(const ProjectTags* tags, const char* name, const char* from)
+{
+    for(const ProjectTag* tag = tags->items, *end = tag + tags->count; tag != end; tag++)
+        if(tag->close && tag->start > from && tag->start[-1] == '\n' && tagIs(tag, name))
+            return tag;
+
+    return NULL;
+}
+
+static bool loadTextSection(const char* project, s32 size, const ProjectTags* tags, char* dst, s32 dstSize)
+{
+    const char* start = project;
+    const char* end = project + size;
+
+    for(const ProjectTag* tag = tags->items, *last = tag + tags->count; tag != last; tag++)
+        if(tag->start > project && tag->start[-1] == '\n')
+        {
+            end = tag->start - 1;
+            break;
+        }
 
     if(end > start)
     {
-        memcpy(dst, start, MIN(size, end - start));
-        done = true;
+        memcpy(dst, start, MIN(dstSize, end - start));
+        return true;
     }
 
-    return done;
+    return false;
 }
 
 static inline const char* getLineEnd(const char* ptr)
@@ -171,57 +268,56 @@ static inline const char* getLineEnd(const char* ptr)
     return ptr;
 }
 
-static bool loadBinarySection(const char* project, const char* comment, const char* tag, s32 count, void* dst, s32 size, bool flip)
+static bool loadBinarySection(const char* project, s32 projectSize, const ProjectTags* tags, const char* comment, const char* tag, s32 count, void* dst, s32 size, bool flip)
 {
-    char tagbuf[64];
-    sprintf(tagbuf, "%s <%s>", comment, tag);
+    const ProjectTag* open = findOpenTag(tags, tag);
 
-    const char* start = strstr(project, tagbuf);
-    bool done = false;
+    if(!open)
+        return false;
 
-    if(start)
-    {
-        start += strlen(tagbuf);
-        start = getLineEnd(start);
+    const char* start = getLineEnd(open->name + open->len + 1);
+    const ProjectTag* close = findCloseTag(tags, tag, start);
 
-        sprintf(tagbuf, "\n%s </%s>", comment, tag);
-        const char* end = strstr(start, tagbuf);
+    // the line break before the closing tag ends the section
+    const char* end = close ? close->start - 1 : NULL;
 
-        if(end > start)
-        {
-            const char* ptr = start;
+    if(!end || end <= start)
+        return false;
 
-            if(size > 0)
-            {
-                while(ptr < end)
-                {
-                    static char lineStr[] = "999";
-                    memcpy(lineStr, ptr + strlen(comment) + 1, sizeof lineStr - 1);
+    const char* last = project + projectSize;
+    const char* ptr = start;
+    s32 prefix = (s32)strlen(comment) + sizeof(" 999:") - 1;
 
-                    s32 index = atoi(lineStr);
+    if(size > 0)
+    {
+        while(ptr < end)
+        {
+            char lineStr[] = "999";
+            memcpy(lineStr, ptr + strlen(comment) + 1, sizeof lineStr - 1);
 
-                    if(index < count)
-                    {
-                        ptr += strlen(comment) + sizeof(" 999:") - 1;
-                        tic_tool_str2buf(ptr, size*2, (u8*)dst + size*index, flip);
-                        ptr += size*2 + 1;
+            s32 index = atoi(lineStr);
 
-                        ptr = getLineEnd(ptr);
-                    }
-                    else break;
-                }
-            }
-            else
+            if(index < count)
             {
-                ptr += strlen(comment) + sizeof(" 999:") - 1;
-                tic_tool_str2buf(ptr, (s32)(end - ptr), (u8*)dst, flip);
-            }
+                ptr += prefix;
+                tic_tool_str2buf(ptr, (s32)MIN(size*2, last - ptr), (u8*)dst + size*index, flip);
+                ptr += size*2 + 1;
+
+                if(ptr >= last)
+                    break;
 
-            done = true;
+                ptr = getLineEnd(ptr);
+            }
+            else break;
         }
     }
+    else
+    {
+        ptr += prefix;
+        tic_tool_str2buf(ptr, (s32)(end - ptr), (u8*)dst, flip);
+    }
 
-    return done;
+    return true;
 }
 
 bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridge* dst)
@@ -232,13 +328,15 @@ bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridg
 
     if(project)
     {
-        memcpy(project, data, size);
-        project[size] = '\0';
-
-        // remove all the '\r' chars
+        // copy up to the first '\0' without the '\r' chars
         {
-            char *s, *d;
-            for(s = d = project; (*d = *s); d += (*s++ != '\r'));
+            char* d = project;
+            for(const char *s = data, *end = data + size; s != end && *s; s++)
+                if(*s != '\r')
+                    *d++ = *s;
+
+            *d = '\0';
+            size = (s32)(d - project);
         }
 
         tic_cartridge* cart = calloc(1, sizeof(tic_cartridge));
@@ -246,9 +344,12 @@ bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridg
         if(cart)
         {
             const char* comment = projectComment(name);
+            ProjectTags tags = {0};
             char tag[16];
 
-            if(loadTextSection(project, comment, cart->code.data, sizeof(tic_code)))
+            indexTags(project, comment, &tags);
+
+            if(loadTextSection(project, size, &tags, cart->code.data, sizeof(tic_code)))
                 done = true;
 
             if(done)
@@ -257,15 +358,16 @@ bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridg
                     for(s32 b = 0; b < TIC_BANKS; b++)
                     {
                         makeTag(section->tag, tag, b);
-                        loadBinarySection(project, comment, tag, section->count, (u8*)&cart->banks[b] + section->offset, section->size, section->flip);
+                        loadBinarySection(project, size, &tags, comment, tag, section->count, (u8*)&cart->banks[b] + section->offset, section->size, section->flip);
                     }
 
-                loadBinarySection(project, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
+                loadBinarySection(project, size, &tags, comment, LangSection.tag, LangSection.count, &cart->lang, LangSection.size, LangSection.flip);
             }
 
             if(done)
                 memcpy(dst, cart, sizeof(tic_cartridge));
 
+            free(tags.items);
             free(cart);
         }
 
@@ -25,4 +25,7 @@
 #include "cart.h"
 
 bool tic_project_load(const char* name, const char* data, s32 size, tic_cartridge* dst);
+
+// exact length of the saved project, tic_project_save writes one more byte for the terminator
+s32 tic_project_size(const char* name, const tic_cartridge* cart);
 s32 tic_project_save(const char* name, void* data, const tic_cartridge* cart);
@@ -0,0 +1,572 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "recorder.h"
+#include "thread.h"
+#include "defines.h"
+#include "tools.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define RECORDER_QUEUE 32
+#define RECORDER_PIXELS (TIC80_FULLWIDTH * TIC80_FULLHEIGHT)
+
+// index 0 is kept for the pixels which didn't change since the previous frame
+#define GIF_TRANSPARENT 0
+#define GIF_MAX_COLORS 256
+#define GIF_COLOR_HASH 1024
+
+#define LZW_MAX_CODE 4096
+#define LZW_HASH 8192
+
+typedef struct
+{
+    u32 pixels[RECORDER_PIXELS];
+} RecorderFrame;
+
+typedef struct
+{
+    s32 x, y, w, h;
+} RecorderRect;
+
+struct tic_recorder
+{
+    s32 scale;
+    s32 fps;
+
+    // frames handed from the main thread to the worker, NULL when frames are added inline
+    RecorderFrame* queue;
+    u32 head;
+    u32 tail;
+    u32 stop;
+    tic_thread* thread;
+
+    // the frame on screen and the one waiting for its delay to be known
+    RecorderFrame* shown;
+    RecorderFrame* pending;
+    RecorderRect rect;
+    s32 delay;
+    s32 frames;
+
+    struct
+    {
+        u32 colors[GIF_MAX_COLORS];
+        s32 count;
+        s32 global;
+        bool overflow;
+
+        u32 keys[GIF_COLOR_HASH];
+        s32 hashed;
+        u8 values[GIF_COLOR_HASH];
+    } palette;
+
+    u8 indices[RECORDER_PIXELS];
+    u8* line;
+
+    struct
+    {
+        u32 keys[LZW_HASH];
+        u16 codes[LZW_HASH];
+        u32 bits;
+        s32 count;
+        u8 block[256];
+    } lzw;
+
+    struct
+    {
+        u8* data;
+        s32 size;
+        s32 capacity;
+    } out;
+};
+
+static void reserve(tic_recorder* rec, s32 size)
+{
+    if(rec->out.size + size > rec->out.capacity)
+    {
+        rec->out.capacity = MAX(rec->out.capacity * 2, rec->out.size + size);
+        rec->out.data = realloc(rec->out.data, rec->out.capacity);
+    }
+}
+
+static void writeBytes(tic_recorder* rec, const void* data, s32 size)
+{
+    reserve(rec, size);
+    memcpy(rec->out.data + rec->out.size, data, size);
+    rec->out.size += size;
+}
+
+static void writeByte(tic_recorder* rec, u8 value)
+{
+    writeBytes(rec, &value, 1);
+}
+
+static void writeWord(tic_recorder* rec, u16 value)
+{
+    writeByte(rec, value & 0xff);
+    writeByte(rec, value >> 8);
+}
+
+static s32 tableBits(s32 count)
+{
+    s32 bits = 1;
+    while((1 << bits) < count)
+        bits++;
+
+    return bits;
+}
+
+static void writeColorTable(tic_recorder* rec, s32 bits)
+{
+    for(s32 i = 0; i < 1 << bits; i++)
+    {
+        u32 color = i < rec->palette.count ? rec->palette.colors[i] : 0;
+        u8 rgb[] = {color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff};
+        writeBytes(rec, rgb, sizeof rgb);
+    }
+}
+
+static void writeHeader(tic_recorder* rec)
+{
+    s32 bits = tableBits(rec->palette.count);
+
+    writeBytes(rec, "GIF89a", 6);
+    writeWord(rec, TIC80_FULLWIDTH * rec->scale);
+    writeWord(rec, TIC80_FULLHEIGHT * rec->scale);
+    writeByte(rec, 0xf0 | (bits - 1));
+    writeByte(rec, GIF_TRANSPARENT);
+    writeByte(rec, 0);
+    writeColorTable(rec, bits);
+
+    // loop forever
+    writeBytes(rec, "\x21\xff\x0bNETSCAPE2.0\x03\x01\x00\x00\x00", 19);
+
+    rec->palette.global = rec->palette.count;
+}
+
+static void resetPalette(tic_recorder* rec)
+{
+    rec->palette.count = GIF_TRANSPARENT + 1;
+    rec->palette.colors[GIF_TRANSPARENT] = 0;
+    rec->palette.hashed = 0;
+    ZEROMEM(rec->palette.keys);
+}
+
+static u8 nearestColor(tic_recorder* rec, u32 color)
+{
+    s32 best = GIF_TRANSPARENT + 1, bestDist = INT32_MAX;
+
+    for(s32 i = GIF_TRANSPARENT + 1; i < rec->palette.count; i++)
+    {
+        u32 c = rec->palette.colors[i];
+        s32 r = (s32)(c & 0xff) - (s32)(color & 0xff);
+        s32 g = (s32)((c >> 8) & 0xff) - (s32)((color >> 8) & 0xff);
+        s32 b = (s32)((c >> 16) & 0xff) - (s32)((color >> 16) & 0xff);
+        s32 dist = r * r + g * g + b * b;
+
+        if(dist < bestDist)
+            best = i, bestDist = dist;
+    }
+
+    return best;
+}
+
+// keys are stored with the top byte set so 0 marks an empty slot
+static u8 colorIndex(tic_recorder* rec, u32 color)
+{
+    u32 key = (color & 0xffffff) | 0xff000000;
+    u32 slot = (key * 2654435761u) >> 22;
+
+    for(;; slot = (slot + 1) & (GIF_COLOR_HASH - 1))
+    {
+        if(rec->palette.keys[slot] == key)
+            return rec->palette.values[slot];
+
+        if(rec->palette.keys[slot] == 0)
+            break;
+    }
+
+    u8 index;
+
+    if(rec->palette.count < GIF_MAX_COLORS)
+        rec->palette.colors[index = rec->palette.count++] = color & 0xffffff;
+    else
+    {
+        rec->palette.overflow = true;
+        index = nearestColor(rec, color);
+    }
+
+    // the nearest matches are only cached while the table is sparse
+    if(rec->palette.hashed < GIF_COLOR_HASH / 2)
+    {
+        rec->palette.keys[slot] = key;
+        rec->palette.values[slot] = index;
+        rec->palette.hashed++;
+    }
+
+    return index;
+}
+
+// maps the changed pixels of the rect to palette indices, returns the highest index used
+static s32 indexFrame(tic_recorder* rec, const RecorderFrame* frame, const RecorderFrame* prev)
+{
+    const RecorderRect* r = &rec->rect;
+    u8* dst = rec->indices;
+    s32 top = GIF_TRANSPARENT;
+
+    for(s32 y = r->y; y < r->y + r->h; y++)
+    {
+        const u32* src = frame->pixels + y * TIC80_FULLWIDTH;
+        const u32* old = prev ? prev->pixels + y * TIC80_FULLWIDTH : NULL;
+
+        for(s32 x = r->x; x < r->x + r->w; x++)
+        {
+            if(old && old[x] == src[x])
+                *dst++ = GIF_TRANSPARENT;
+            else
+            {
+                u8 index = colorIndex(rec, src[x]);
+                top = MAX(top, index);
+                *dst++ = index;
+            }
+        }
+    }
+
+    return top;
+}
+
+static void flushBlock(tic_recorder* rec)
+{
+    if(rec->lzw.block[0])
+    {
+        writeBytes(rec, rec->lzw.block, rec->lzw.block[0] + 1);
+        rec->lzw.block[0] = 0;
+    }
+}
+
+static void writeCode(tic_recorder* rec, u32 code, s32 size)
+{
+    rec->lzw.bits |= code << rec->lzw.count;
+    rec->lzw.count += size;
+
+    while(rec->lzw.count >= 8)
+    {
+        rec->lzw.block[++rec->lzw.block[0]] = rec->lzw.bits & 0xff;
+        rec->lzw.bits >>= 8;
+        rec->lzw.count -= 8;
+
+        if(rec->lzw.block[0] == 255)
+            flushBlock(rec);
+    }
+}
+
+static void writeImage(tic_recorder* rec, s32 bits)
+{
+    const RecorderRect* r = &rec->rect;
+    s32 scale = rec->scale;
+    s32 width = r->w * scale;
+
+    s32 minSize = MAX(bits, 2);
+    u32 clear = 1 << minSize, end = clear + 1;
+    u32 next = end + 1;
+    s32 size = minSize + 1;
+    s32 prefix = -1;
+
+    writeByte(rec, minSize);
+    rec->lzw.bits = rec->lzw.count = 0;
+    rec->lzw.block[0] = 0;
+    ZEROMEM(rec->lzw.keys);
+    writeCode(rec, clear, size);
+
+    for(s32 y = 0; y < r->h; y++)
+    {
+        const u8* src = rec->indices + y * r->w;
+        u8* line = rec->line;
+
+        for(s32 x = 0; x < r->w; x++)
+            for(s32 i = 0; i < scale; i++)
+                *line++ = src[x];
+
+        for(s32 i = 0; i < scale; i++)
+        {
+            for(s32 x = 0; x < width; x++)
+            {
+                u8 value = rec->line[x];
+
+                if(prefix < 0)
+                {
+                    prefix = value;
+                    continue;
+                }
+
+                u32 key = ((u32)prefix << 8 | value) + 1;
+                u32 slot = (key * 2654435761u) >> 19;
+
+                while(rec->lzw.keys[slot] && rec->lzw.keys[slot] != key)
+                    slot = (slot + 1) & (LZW_HASH - 1);
+
+                if(rec->lzw.keys[slot])
+                {
+                    prefix = rec->lzw.codes[slot];
+                    continue;
+                }
+
+                writeCode(rec, prefix, size);
+                prefix = value;
+
+                rec->lzw.keys[slot] = key;
+                rec->lzw.codes[slot] = next;
+
+                if(next++ >= 1u << size)
+                    size++;
+
+                if(next == LZW_MAX_CODE)
+                {
+                    writeCode(rec, clear, size);
+                    ZEROMEM(rec->lzw.keys);
+                    next = end + 1;
+                    size = minSize + 1;
+                }
+            }
+        }
+    }
+
+    writeCode(rec, prefix, size);
+    writeCode(rec, end, size);
+    writeCode(rec, 0, 7);
+    flushBlock(rec);
+    writeByte(rec, 0);
+}
+
+static void writeFrame(tic_recorder* rec)
+{
+    const RecorderFrame* prev = rec->out.size ? rec->shown : NULL;
+
+    rec->palette.overflow = false;
+    s32 top = indexFrame(rec, rec->pending, prev);
+
+    // no room for the new colors, start a palette from this frame alone,
+    // the global table doesn't match the indices after that
+    if(rec->palette.overflow)
+    {
+        resetPalette(rec);
+        rec->palette.global = 0;
+        rec->palette.overflow = false;
+        top = indexFrame(rec, rec->pending, prev);
+    }
+
+    if(!rec->out.size)
+        writeHeader(rec);
+
+    const RecorderRect* r = &rec->rect;
+    s32 scale = rec->scale;
+
+    u8 control[] = {0x21, 0xf9, 4, 1 << 2 | 1, rec->delay & 0xff, rec->delay >> 8, GIF_TRANSPARENT, 0};
+    writeBytes(rec, control, sizeof control);
+
+    writeByte(rec, 0x2c);
+    writeWord(rec, r->x * scale);
+    writeWord(rec, r->y * scale);
+    writeWord(rec, r->w * scale);
+    writeWord(rec, r->h * scale);
+
+    s32 bits;
+
+    if(top < rec->palette.global)
+    {
+        bits = tableBits(rec->palette.global);
+        writeByte(rec, 0);
+    }
+    else
+    {
+        bits = tableBits(rec->palette.count);
+        writeByte(rec, 0x80 | (bits - 1));
+        writeColorTable(rec, bits);
+    }
+
+    writeImage(rec, bits);
+}
+
+static inline bool sameRow(const RecorderFrame* a, const RecorderFrame* b, s32 y)
+{
+    return memcmp(a->pixels + y * TIC80_FULLWIDTH, b->pixels + y * TIC80_FULLWIDTH, TIC80_FULLWIDTH * sizeof(u32)) == 0;
+}
+
+static bool diffFrames(const RecorderFrame* a, const RecorderFrame* b, RecorderRect* rect)
+{
+    s32 top = 0, bottom = TIC80_FULLHEIGHT - 1;
+
+    while(top < TIC80_FULLHEIGHT && sameRow(a, b, top))
+        top++;
+
+    if(top == TIC80_FULLHEIGHT)
+        return false;
+
+    while(sameRow(a, b, bottom))
+        bottom--;
+
+    s32 left = TIC80_FULLWIDTH, right = 0;
+
+    for(s32 y = top; y <= bottom; y++)
+    {
+        const u32* pa = a->pixels + y * TIC80_FULLWIDTH;
+        const u32* pb = b->pixels + y * TIC80_FULLWIDTH;
+
+        for(s32 x = 0; x < left; x++)
+            if(pa[x] != pb[x])
+            {
+                left = x;
+                break;
+            }
+
+        for(s32 x = TIC80_FULLWIDTH - 1; x > right; x--)
+            if(pa[x] != pb[x])
+            {
+                right = x;
+                break;
+            }
+    }
+
+    right = MAX(left, right);
+    *rect = (RecorderRect){left, top, right - left + 1, bottom - top + 1};
+
+    return true;
+}
+
+// GIF delays are in 1/100s, so they are spread to keep the average rate
+static s32 frameDelay(tic_recorder* rec)
+{
+    s32 n = rec->frames++;
+    return ((n + 1) * 100 + rec->fps / 2) / rec->fps - (n * 100 + rec->fps / 2) / rec->fps;
+}
+
+static void addFrame(tic_recorder* rec, const RecorderFrame* frame)
+{
+    s32 delay = frameDelay(rec);
+    RecorderRect rect = {0, 0, TIC80_FULLWIDTH, TIC80_FULLHEIGHT};
+
+    if(rec->frames > 1)
+    {
+        // unchanged frames only extend the delay of the previous one
+        if(!diffFrames(rec->pending, frame, &rect))
+        {
+            rec->delay = MIN(rec->delay + delay, 0xffff);
+            return;
+        }
+
+        writeFrame(rec);
+
+        RecorderFrame* shown = rec->shown;
+        rec->shown = rec->pending;
+        rec->pending = shown;
+    }
+
+    memcpy(rec->pending, frame, sizeof *frame);
+    rec->rect = rect;
+    rec->delay = delay;
+}
+
+static void recorderLoop(void* data)
+{
+    tic_recorder* rec = data;
+
+    for(;;)
+    {
+        u32 tail = rec->tail;
+
+        if(tail != LOAD_ACQUIRE(rec->head))
+        {
+            addFrame(rec, &rec->queue[tail % RECORDER_QUEUE]);
+            STORE_RELEASE(rec->tail, tail + 1);
+        }
+        else if(LOAD_ACQUIRE(rec->stop))
+            break;
+        else tic_thread_sleep(1);
+    }
+}
+
+tic_recorder* tic_recorder_start(s32 scale, s32 fps)
+{
+    tic_recorder* rec = calloc(1, sizeof(tic_recorder));
+
+    rec->scale = MAX(scale, 1);
+    rec->fps = MAX(fps, 1);
+    rec->shown = malloc(sizeof(RecorderFrame));
+    rec->pending = malloc(sizeof(RecorderFrame));
+    rec->line = malloc(TIC80_FULLWIDTH * rec->scale);
+    resetPalette(rec);
+
+    rec->queue = malloc(sizeof(RecorderFrame) * RECORDER_QUEUE);
+
+    // without the worker the frames are encoded on the main thread
+    if(rec->queue && !(rec->thread = tic_thread_create(recorderLoop, rec)))
+    {
+        free(rec->queue);
+        rec->queue = NULL;
+    }
+
+    return rec;
+}
+
+void tic_recorder_frame(tic_recorder* rec, const u32* pixels)
+{
+    if(rec->queue)
+    {
+        u32 head = rec->head;
+
+        while(head - LOAD_ACQUIRE(rec->tail) == RECORDER_QUEUE)
+            tic_thread_sleep(1);
+
+        memcpy(rec->queue[head % RECORDER_QUEUE].pixels, pixels, sizeof(RecorderFrame));
+        STORE_RELEASE(rec->head, head + 1);
+        return;
+    }
+
+    addFrame(rec, (const RecorderFrame*)pixels);
+}
+
+void* tic_recorder_finish(tic_recorder* rec, s32* size)
+{
+    if(rec->queue)
+    {
+        STORE_RELEASE(rec->stop, 1);
+        tic_thread_join(rec->thread);
+        free(rec->queue);
+    }
+
+    if(rec->frames)
+    {
+        writeFrame(rec);
+        writeByte(rec, 0x3b);
+    }
+
+    void* data = rec->out.data;
+    *size = rec->out.size;
+
+    free(rec->shown);
+    free(rec->pending);
+    free(rec->line);
+    free(rec);
+
+    return data;
+}
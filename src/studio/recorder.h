@@ -0,0 +1,39 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "api.h"
+
+// GIF recorder for the studio screen, the main thread only copies the frame
+// and a worker thread indexes, diffs, scales and encodes it
+
+typedef struct tic_recorder tic_recorder;
+
+tic_recorder* tic_recorder_start(s32 scale, s32 fps);
+
+// queues a TIC80_FULLWIDTH x TIC80_FULLHEIGHT frame, blocks only when the worker is far behind
+void tic_recorder_frame(tic_recorder* recorder, const u32* pixels);
+
+// waits for the queued frames and frees the recorder, returns the GIF data to be freed by the caller
+void* tic_recorder_finish(tic_recorder* recorder, s32* size);
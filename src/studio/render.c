@@ -0,0 +1,202 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "render.h"
+#include "thread.h"
+#include "defines.h"
+#include "tools.h"
+#include "retro_endianness.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RENDER_MAX_THREADS 64
+
+// music is rendered up to 16 times through all the frames if it loops
+#define RENDER_MUSIC_FRAMES (MUSIC_FRAMES * 16)
+
+static void writeLE(FILE* file, u32 value, s32 size)
+{
+    for(s32 i = 0; i < size; i++, value >>= 8)
+        fputc(value & 0xff, file);
+}
+
+void tic_render_wav_header(FILE* file, s32 samplerate, u32 size)
+{
+    enum {Bits = 16, Align = TIC80_SAMPLE_CHANNELS * Bits / 8};
+
+    fwrite("RIFF", 4, 1, file);
+    writeLE(file, size + 36, 4);
+    fwrite("WAVEfmt ", 8, 1, file);
+    writeLE(file, 16, 4);
+    writeLE(file, 1, 2); // PCM
+    writeLE(file, TIC80_SAMPLE_CHANNELS, 2);
+    writeLE(file, samplerate, 4);
+    writeLE(file, samplerate * Align, 4);
+    writeLE(file, Align, 2);
+    writeLE(file, Bits, 2);
+    fwrite("data", 4, 1, file);
+    writeLE(file, size, 4);
+}
+
+static u32 renderFrame(tic_mem* tic, const tic_render_job* job, FILE* file)
+{
+    tic_core_tick_start(tic);
+
+    for (s32 i = 0; i < TIC_SOUND_CHANNELS; i++)
+        if(!(job->channels & (1 << i)))
+            tic->ram->registers[i].volume = 0;
+
+    tic_core_tick_end(tic);
+    tic_core_synth_sound(tic);
+
+    s16* samples = tic->product.samples.buffer;
+    s32 count = tic->product.samples.count;
+
+#if RETRO_IS_BIG_ENDIAN
+    for(s32 i = 0; i < count; i++)
+        samples[i] = retro_cpu_to_le16(samples[i]);
+#endif
+
+    return (u32)fwrite(samples, sizeof(s16), count, file) * sizeof(s16);
+}
+
+static u32 renderSfx(tic_mem* tic, const tic_render_job* job, FILE* file)
+{
+    const tic_sample* effect = &job->sfx->samples.data[job->index];
+    u32 size = 0;
+
+    enum{Channel = 0};
+    tic_api_sfx(tic, job->index, effect->note, effect->octave, -1, Channel, MAX_VOLUME, MAX_VOLUME, SFX_DEF_SPEED);
+
+    for(s32 ticks = 0, pos = 0; pos < SFX_TICKS; pos = tic_tool_sfx_pos(effect->speed, ++ticks))
+        size += renderFrame(tic, job, file);
+
+    return size;
+}
+
+static u32 renderMusic(tic_mem* tic, const tic_render_job* job, FILE* file)
+{
+    const tic_music_state* state = &tic->ram->music_state;
+    u32 size = 0;
+
+    if(job->frame || job->row)
+    {
+        // skip to the start position without rendering the part before it
+        if(tic_core_music_seek(tic, job->index, job->frame, job->row, false, job->sustain, -1, -1) < 0)
+            return 0;
+    }
+    else tic_api_music(tic, job->index, -1, -1, false, job->sustain, -1, -1);
+
+    s32 frame = state->music.frame;
+    s32 frames = RENDER_MUSIC_FRAMES;
+
+    while(frames && state->flag.music_status == tic_music_play)
+    {
+        size += renderFrame(tic, job, file);
+
+        if(frame != state->music.frame)
+        {
+            --frames;
+            frame = state->music.frame;
+        }
+    }
+
+    return size;
+}
+
+static bool renderJob(tic_render_job* job)
+{
+    FILE* file = fopen(job->path, "wb");
+
+    if(!file)
+        return false;
+
+    tic_mem* tic = tic_core_create(job->samplerate, TIC80_PIXEL_COLOR_RGBA8888);
+
+    memcpy(&tic->ram->sfx, job->sfx, sizeof tic->ram->sfx);
+    memcpy(&tic->ram->music, job->music, sizeof tic->ram->music);
+
+    // the sizes are patched once the data is written
+    tic_render_wav_header(file, job->samplerate, 0);
+
+    u32 size = job->type == tic_render_sfx
+        ? renderSfx(tic, job, file)
+        : renderMusic(tic, job, file);
+
+    fseek(file, 0, SEEK_SET);
+    tic_render_wav_header(file, job->samplerate, size);
+
+    tic_core_close(tic);
+
+    return !ferror(file) & (fclose(file) == 0);
+}
+
+typedef struct
+{
+    tic_render_job* jobs;
+    s32 count;
+    s32 first;
+    s32 step;
+} RenderWorker;
+
+static void renderJobs(void* data)
+{
+    RenderWorker* worker = data;
+
+    for(s32 i = worker->first; i < worker->count; i += worker->step)
+        worker->jobs[i].done = renderJob(&worker->jobs[i]);
+}
+
+s32 tic_render(tic_render_job* jobs, s32 count)
+{
+    if(count <= 0)
+        return 0;
+
+    s32 threads = CLAMP(tic_thread_cores(), 1, MIN(count, RENDER_MAX_THREADS));
+
+    RenderWorker workers[RENDER_MAX_THREADS];
+    tic_thread* handles[RENDER_MAX_THREADS];
+
+    for(s32 i = 0; i < threads; i++)
+        workers[i] = (RenderWorker){jobs, count, i, threads};
+
+    // a worker that can't be started renders its share right away
+    for(s32 i = 1; i < threads; i++)
+        handles[i] = tic_thread_start(renderJobs, &workers[i]);
+
+    // the calling thread takes the first share
+    renderJobs(&workers[0]);
+
+    for(s32 i = 1; i < threads; i++)
+        tic_thread_join(handles[i]);
+
+    s32 failed = 0;
+
+    for(s32 i = 0; i < count; i++)
+        if(!jobs[i].done)
+            failed++;
+
+    return failed;
+}
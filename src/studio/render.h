@@ -0,0 +1,61 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include "api.h"
+#include "system.h"
+
+#include <stdio.h>
+
+// offline sound renderer, every job runs on its own core so jobs can run
+// in parallel without touching the live studio state
+
+typedef enum
+{
+    tic_render_sfx,
+    tic_render_music,
+} tic_render_type;
+
+typedef struct
+{
+    tic_render_type type;
+    s32 index;
+    s32 samplerate;
+    u8 channels; // mask of audible channels
+    bool sustain;
+    s32 frame; // music start position
+    s32 row;
+
+    const tic_sfx* sfx;
+    const tic_music* music;
+
+    char path[TICNAME_MAX];
+    bool done;
+} tic_render_job;
+
+// renders all the jobs to .wav files using all the CPU cores, returns the number of failed jobs
+s32 tic_render(tic_render_job* jobs, s32 count);
+
+// 16-bit stereo PCM header, size is the length of the sample data in bytes
+void tic_render_wav_header(FILE* file, s32 samplerate, u32 size);
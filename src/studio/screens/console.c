@@ -125,6 +125,11 @@
     macro(bank)                 \
     macro(vbank)                \
     macro(id)                   \
+    macro(all)                  \
+    macro(stems)                \
+    macro(rate)                 \
+    macro(frame)                \
+    macro(row)                  \
     ALONE_KEY(macro)
 
 static const char* WelcomeText =
@@ -2377,26 +2382,41 @@ static void onExport_mapimg(Console* console, const char* param, const char* pat
     }
 }
 
+static void onSoundExported(Console* console, const char* filename, s32 files)
+{
+    if(files > 1)
+    {
+        char buf[TICNAME_MAX];
+        sprintf(buf, "%i files from %s", files, filename);
+        onFileExported(console, buf, true);
+    }
+    else onFileExported(console, filename, files > 0);
+}
+
 static void onExport_sfx(Console* console, const char* param, const char* name, ExportParams params)
 {
     const char* filename = getFilename(name, ".wav");
-    bool error = true;
+    s32 files = -1;
 
-    if(params.id >= 0 && params.id < SFX_COUNT)
-        error = studioExportSfx(console->studio, params.id, filename) == NULL;
+    if(params.all)
+        files = studioExportSfx(console->studio, -1, filename, params.rate);
+    else if(params.id >= 0 && params.id < SFX_COUNT)
+        files = studioExportSfx(console->studio, params.id, filename, params.rate);
 
-    onFileExported(console, filename, !error);
+    onSoundExported(console, filename, files);
 }
 
 static void onExport_music(Console* console, const char* type, const char* name, ExportParams params)
 {
     const char* filename = getFilename(name, ".wav");
-    bool error = true;
+    s32 files = -1;
 
-    if(params.id >= 0 && params.id < MUSIC_TRACKS)
-        error = studioExportMusic(console->studio, params.id, params.bank, filename) == NULL;
+    if(params.all)
+        files = studioExportMusic(console->studio, -1, params.bank, filename, params.rate, params.stems, params.frame, params.row);
+    else if(params.id >= 0 && params.id < MUSIC_TRACKS)
+        files = studioExportMusic(console->studio, params.id, params.bank, filename, params.rate, params.stems, params.frame, params.row);
 
-    onFileExported(console, filename, !error);
+    onSoundExported(console, filename, files);
 }
 
 static void onExport_screen(Console* console, const char* param, const char* name, ExportParams params)
@@ -2478,7 +2498,7 @@ static void drawShadowText(tic_mem* tic, const char* text, s32 x, s32 y, tic_col
 
 const char* readMetatag(const char* code, const char* tag, const char* comment);
 
-static CartSaveResult saveCartName(Console* console, const char* name)
+static CartSaveResult saveCartName(Console* console, const char* name, bool zip)
 {
     tic_mem* tic = console->tic;
 
@@ -2596,7 +2616,9 @@ static CartSaveResult saveCartName(Console* console, const char* name)
                 else
                 {
                     name = getCartName(name);
-                    size = tic_cart_save(&tic->cart, buffer);
+                    size = zip
+                        ? tic_cart_save_zip(&tic->cart, buffer)
+                        : tic_cart_save(&tic->cart, buffer);
                 }
 
                 if(size && tic_fs_save(console->fs, name, buffer, size, true))
@@ -2612,7 +2634,7 @@ static CartSaveResult saveCartName(Console* console, const char* name)
     }
     else if (strlen(console->rom.name))
     {
-        return saveCartName(console, console->rom.name);
+        return saveCartName(console, console->rom.name, zip);
     }
     else return CART_SAVE_MISSING_NAME;
 
@@ -2621,12 +2643,13 @@ static CartSaveResult saveCartName(Console* console, const char* name)
 
 static CartSaveResult saveCart(Console* console)
 {
-    return saveCartName(console, NULL);
+    return saveCartName(console, NULL, false);
 }
 
 static void onSaveCommandConfirmed(Console* console)
 {
-    CartSaveResult rom = saveCartName(console, console->desc->count ? console->desc->params->key : NULL);
+    bool zip = console->desc->count > 1 && strcmp(console->desc->params[1].key, "zip") == 0;
+    CartSaveResult rom = saveCartName(console, console->desc->count ? console->desc->params->key : NULL, zip);
 
     if(rom == CART_SAVE_OK)
     {
@@ -2936,8 +2959,9 @@ static const char HelpUsage[] = "help [<text>"
         NULL,                                                                           \
         "Save cartridge to the local filesystem (Hotkey: CTRL+S), use $LANG_EXTENSIONS$"\
         "cart extension to save it in text format (PRO feature).\n"                     \
-        "Use .png file extension to save it as a png cart.",                            \
-        "save <cart>",                                                                  \
+        "Use .png file extension to save it as a png cart.\n"                           \
+        "Use zip to compress the cart sections, older versions load them empty.",       \
+        "save <cart> [zip]",                                                            \
         onSaveCommand,                                                                  \
         tabCompleteFiles,                                                               \
         NULL)                                                                           \
@@ -3009,7 +3033,10 @@ static const char HelpUsage[] = "help [<text>"
         "Export cart to HTML,\n"                                                        \
         "native build (win linux rpi mac),\n"                                           \
         "export sprites/map/... as a .png image "                                       \
-        "or export sfx and music to .wav files.",                                       \
+        "or export sfx and music to .wav files\n"                                       \
+        "(all=1 renders every track/sfx in parallel, stems=1 adds\n"                    \
+        "a file per music channel, rate=<hz> sets the sample rate,\n"                   \
+        "frame=<n> row=<n> start the music export from that position).",                \
         "\nexport [" EXPORT_CMD_LIST(EXPORT_CMD_DEF) "] "                            \
         "<file> [" EXPORT_KEYS_LIST(EXPORT_KEYS_DEF) "]" ,                           \
         onExportCommand,                                                                \
@@ -4474,7 +4501,7 @@ void forceAutoSave(Console* console, const char* cart_name)
     char namepath[TICNAME_MAX];
     strcpy(namepath, "/downloads/");
     strcat(namepath, cart_name);
-    CartSaveResult rom = saveCartName(console, namepath);
+    CartSaveResult rom = saveCartName(console, namepath, false);
 
     if(rom == CART_SAVE_OK)
     {
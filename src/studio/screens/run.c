@@ -23,6 +23,7 @@
 #include "run.h"
 #include "console.h"
 #include "studio/fs.h"
+#include "studio/thread.h"
 #include "ext/md5.h"
 #include <time.h>
 
@@ -30,6 +31,17 @@
 #include "ticbuild_remoting/user_timing.h"
 #endif
 
+// pmem is written at most once per this many ms
+#define PMEM_SAVE_DELAY 500
+
+struct PMemWriter
+{
+    char path[TICNAME_MAX];
+    tic_persistent data;
+    u32 busy;
+    tic_thread* thread;
+};
+
 static void onTrace(void* data, const char* text, u8 color)
 {
 #if defined(BUILD_EDITORS)
@@ -100,6 +112,68 @@ static void initPMemName(Run* run)
     strcat(run->saveid, md5);
 }
 
+static void writePMem(void* data)
+{
+    PMemWriter* writer = data;
+
+    fs_write(writer->path, &writer->data, sizeof(tic_persistent));
+    STORE_RELEASE(writer->busy, 0);
+}
+
+static void joinWriter(PMemWriter* writer)
+{
+    tic_thread_join(writer->thread);
+    writer->thread = NULL;
+}
+
+// the data is written right here when the thread can't be started
+static void startWriter(PMemWriter* writer)
+{
+    STORE_RELEASE(writer->busy, 1);
+    writer->thread = tic_thread_start(writePMem, writer);
+}
+
+// the dirty flag is lost on reset, so a flush compares the data anyway
+static void savePMem(Run* run, bool flush)
+{
+    enum {Size = sizeof(tic_persistent)};
+
+    tic_mem* tic = run->tic;
+    PMemWriter* writer = run->save.writer;
+
+    if(!tic || !writer)
+        return;
+
+    if(tic_core_pmem_dirty(tic))
+        run->save.dirty = true;
+
+    u64 now = tic_sys_counter_get();
+
+    if(flush)
+        joinWriter(writer);
+    else if(!run->save.dirty
+        || now - run->save.time < PMEM_SAVE_DELAY * tic_sys_freq_get() / 1000
+        || LOAD_ACQUIRE(writer->busy))
+        return;
+
+    run->save.dirty = false;
+
+    if(memcmp(run->pmem.data, tic->ram->persistent.data, Size) == 0)
+        return;
+
+    joinWriter(writer);
+
+    strcpy(writer->path, tic_fs_pathroot(run->fs, run->saveid));
+    memcpy(writer->data.data, tic->ram->persistent.data, Size);
+    memcpy(run->pmem.data, tic->ram->persistent.data, Size);
+    run->save.time = now;
+
+    startWriter(writer);
+
+    if(flush)
+        joinWriter(writer);
+}
+
 static void tick(Run* run)
 {
     if (getStudioMode(run->studio) != TIC_RUN_MODE)
@@ -120,13 +194,7 @@ static void tick(Run* run)
     ticbuild_user_timing_install(tic);
 #endif
 
-    enum {Size = sizeof(tic_persistent)};
-
-    if(memcmp(run->pmem.data, tic->ram->persistent.data, Size))
-    {
-        tic_fs_saveroot(run->fs, run->saveid, &tic->ram->persistent, Size, true);
-        memcpy(run->pmem.data, tic->ram->persistent.data, Size);
-    }
+    savePMem(run, run->exit);
 
     if(run->exit)
 #if defined(BUILD_EDITORS)
@@ -148,6 +216,11 @@ static u64 getCounter(void* data)
 
 void initRun(Run* run, Console* console, tic_fs* fs, Studio* studio)
 {
+    // the previous game's pmem is written before the state is reset
+    savePMem(run, true);
+
+    PMemWriter* writer = run->save.writer;
+
     *run = (Run)
     {
         .studio = studio,
@@ -165,6 +238,7 @@ void initRun(Run* run, Console* console, tic_fs* fs, Studio* studio)
             .counter = getCounter,
             .freq = getFreq
         },
+        .save.writer = writer ? writer : calloc(1, sizeof(PMemWriter)),
     };
 
     {
@@ -190,5 +264,8 @@ void initRun(Run* run, Console* console, tic_fs* fs, Studio* studio)
 
 void freeRun(Run* run)
 {
+    savePMem(run, true);
+
+    FREE(run->save.writer);
     free(run);
 }
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "studio/studio.h"
 
 typedef struct Run Run;
+typedef struct PMemWriter PMemWriter;
 
 struct Run
 {
@@ -40,6 +41,14 @@ struct Run
     char saveid[TICNAME_MAX];
     tic_persistent pmem;
 
+    // pmem changes are batched and written in the background
+    struct
+    {
+        bool dirty;
+        u64 time;
+        PMemWriter* writer;
+    } save;
+
     void(*tick)(Run*);
 };
 
@@ -24,6 +24,7 @@
 #include "studio/fs.h"
 #include "studio/net.h"
 #include "studio/config.h"
+#include "studio/cartindex.h"
 #include "console.h"
 #include "menu.h"
 #include "ext/gif.h"
@@ -61,6 +62,9 @@ struct SurfItem
     s32 id;
     tic_screen* cover;
 
+    // title, author and script of a local cart from the index
+    char* meta;
+
     tic_palette* palette;
 
     bool coverLoading;
@@ -138,6 +142,16 @@ static void drawBottomToolbar(Surf* surf, s32 x, s32 y)
         tic_api_print(tic, label, xl, yl, tic_color_white, true, 1, false);
     }
 
+    if(surf->menu.count > 0 && getMenuItem(surf)->meta)
+    {
+        const char* meta = getMenuItem(surf)->meta;
+        s32 width = tic_api_print(tic, meta, 0, -TIC_FONT_HEIGHT, tic_color_white, true, 1, true);
+        s32 xl = MAX(TIC80_WIDTH / 2, TIC80_WIDTH - MAIN_OFFSET - width);
+        s32 yl = y + (Height - TIC_FONT_HEIGHT)/2;
+        tic_api_print(tic, meta, xl, yl+1, tic_color_black, true, 1, true);
+        tic_api_print(tic, meta, xl, yl, tic_color_white, true, 1, true);
+    }
+
 #ifdef CAN_OPEN_URL
 
     if(surf->menu.count > 0 && getMenuItem(surf)->hash)
@@ -275,6 +289,7 @@ static void resetMenu(Surf* surf)
             FREE(item->cover);
             FREE(item->label);
             FREE(item->palette);
+            FREE(item->meta);
         }
 
         free(surf->menu.items);
@@ -284,6 +299,7 @@ static void resetMenu(Surf* surf)
     }
 
     surf->menu.pos = 0;
+    surf->menu.prefetch = 0;
 }
 
 static void updateMenuItemCover(Surf* surf, s32 pos, const u8* cover, s32 size)
@@ -375,6 +391,23 @@ static void requestCover(Surf* surf, SurfItem* item)
     tic_net_get(surf->net, path, coverLoaded, MOVE(coverLoadingData));
 }
 
+// "title by author [script]", skipping what the cart doesn't have
+static char* makeMeta(const tic_cartindex_info* info)
+{
+    char meta[TIC_CARTINDEX_TEXT * 3 + 16] = "";
+
+    if(*info->title)
+        strcat(meta, info->title);
+
+    if(*info->author)
+        strcat(strcat(meta, *meta ? " by " : "by "), info->author);
+
+    if(*info->script)
+        strcat(strcat(strcat(meta, *meta ? " [" : "["), info->script), "]");
+
+    return *meta ? strdup(meta) : NULL;
+}
+
 static void loadCover(Surf* surf)
 {
     tic_mem* tic = surf->tic;
@@ -384,60 +417,52 @@ static void loadCover(Surf* surf)
     if(item->coverLoading)
         return;
 
-    item->coverLoading = true;
-
     if(!tic_fs_ispubdir(surf->fs))
     {
+        tic_cartindex_info info;
 
-        s32 size = 0;
-        void* data = tic_fs_load(surf->fs, item->name, &size);
-
-        if(data)
+        if(item->dir)
+            item->coverLoading = true;
+        else if(tic_cartindex_find(surf->index, tic_fs_path(surf->fs, item->name), &info))
         {
-            tic_cartridge* cart = (tic_cartridge*)malloc(sizeof(tic_cartridge));
+            item->coverLoading = true;
+            item->meta = makeMeta(&info);
 
-            if(cart)
+            if(info.cover)
             {
-
-                if(tic_tool_has_ext(item->name, PngExt))
-                {
-                    tic_cartridge* pngcart = loadPngCart((png_buffer){data, size});
-
-                    if(pngcart)
-                    {
-                        memcpy(cart, pngcart, sizeof(tic_cartridge));
-                        free(pngcart);
-                    }
-                    else memset(cart, 0, sizeof(tic_cartridge));
-                }
-#if defined(TIC80_PRO)
-                else if(project_ext(item->name))
-                    tic_project_load(item->name, data, size, cart);
-#endif
-                else
-                    tic_cart_load(cart, data, size);
-
-                if(!EMPTY(cart->bank0.screen.data) && !EMPTY(cart->bank0.palette.vbank0.data))
-                {
-                    memcpy((item->palette = malloc(sizeof(tic_palette))), &cart->bank0.palette.vbank0, sizeof(tic_palette));
-                    memcpy((item->cover = malloc(sizeof(tic_screen))), &cart->bank0.screen, sizeof(tic_screen));
-                }
-
-                free(cart);
+                memcpy((item->palette = malloc(sizeof(tic_palette))), &info.palette, sizeof(tic_palette));
+                memcpy((item->cover = malloc(sizeof(tic_screen))), &info.screen, sizeof(tic_screen));
             }
-
-            free(data);
         }
     }
-    else if(item->hash && !item->cover)
+    else
     {
-        requestCover(surf, item);
+        item->coverLoading = true;
+
+        if(item->hash && !item->cover)
+            requestCover(surf, item);
+    }
+}
+
+// queues the local carts of the folder so their covers are ready when scrolled to
+static void prefetchCovers(Surf* surf)
+{
+    if(tic_fs_ispubdir(surf->fs))
+        return;
+
+    for(; surf->menu.prefetch < surf->menu.count; surf->menu.prefetch++)
+    {
+        const SurfItem* item = &surf->menu.items[surf->menu.prefetch];
+
+        if(!item->dir && !tic_cartindex_request(surf->index, tic_fs_path(surf->fs, item->name)))
+            break;
     }
 }
 
 static void initItemsAsync(Surf* surf, fs_done_callback callback, void* calldata)
 {
     resetMenu(surf);
+    tic_cartindex_recheck(surf->index);
 
     surf->loading = true;
 
@@ -610,13 +635,15 @@ static void loadCart(Surf* surf)
 
         if(data)
         {
-            tic_cartridge* cart = loadPngCart((png_buffer){data, size});
+            tic_cart_view* view = tic_cart_view_open(data, size);
 
-            if(cart)
+            if(view)
             {
                 surf->anim.movie = resetMovie(&surf->anim.play);
-                free(cart);
+                tic_cart_view_close(view);
             }
+
+            free(data);
         }
     }
     else surf->anim.movie = resetMovie(&surf->anim.play);
@@ -746,9 +773,12 @@ static void tick(Surf* surf)
 
     if (getStudioMode(surf->studio) != TIC_SURF_MODE) return;
 
+    tic_cartindex_update(surf->index);
+
     if (surf->menu.count > 0)
     {
         loadCover(surf);
+        prefetchCovers(surf);
 
         tic_screen* cover = getMenuItem(surf)->cover;
 
@@ -842,6 +872,9 @@ void initSurf(Surf* surf, Studio* studio, struct Console* console)
 {
     freeAnim(surf);
 
+    // the index is kept between the visits
+    struct tic_cartindex* index = surf->index;
+
     *surf = (Surf)
     {
         .studio = studio,
@@ -850,6 +883,7 @@ void initSurf(Surf* surf, Studio* studio, struct Console* console)
         .config = console->config,
         .fs = console->fs,
         .net = console->net,
+        .index = index,
         .tick = tick,
         .ticks = 0,
         .init = false,
@@ -921,11 +955,17 @@ void initSurf(Surf* surf, Studio* studio, struct Console* console)
     surf->anim.movie = resetMovie(&surf->anim.idle);
 
     tic_fs_makedir(surf->fs, TIC_CACHE);
+
+    if(surf->index)
+        tic_cartindex_save(surf->index);
+    else
+        surf->index = tic_cartindex_open(tic_fs_pathroot(surf->fs, TIC_CACHE "surf.idx"));
 }
 
 void freeSurf(Surf* surf)
 {
     freeAnim(surf);
     resetMenu(surf);
+    tic_cartindex_close(surf->index);
     free(surf);
 }
@@ -34,6 +34,7 @@ struct Surf
     struct tic_net* net;
     struct Console* console;
     struct Config* config;
+    struct tic_cartindex* index;
 
     bool init;
     bool loading;
@@ -45,6 +46,7 @@ struct Surf
         s32 target;
         struct SurfItem* items;
         s32 count;
+        s32 prefetch;
     } menu;
 
     struct
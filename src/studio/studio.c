@@ -42,10 +42,10 @@
 #include "net.h"
 #include "ticbuild_remoting/remoting.h"
 #include "ticbuild_remoting/user_timing.h"
-#include "wave_writer.h"
+#include "render.h"
+#include "recorder.h"
+#include "capture.h"
 #include "ext/gif.h"
-#define MSF_GIF_IMPL
-#include "ext/msf_gif.h"
 
 #include "../fftdata.h"
 #include "ext/fft.h"
@@ -62,6 +62,7 @@
 
 #include "api.h"
 #include "ticbuild_remoting/lua_eval.h"
+#include "ticbuild_remoting/carthash.h"
 
 #include "fs.h"
 
@@ -78,6 +79,15 @@
 
 #define MD5_HASHSIZE 16
 
+// frames without input or activity before the editors stop redrawing
+#define STUDIO_IDLE_FRAMES TIC80_FRAMERATE
+
+#if defined(__TIC_WINDOWS__)
+#define WATCH_LIST_SEPARATOR ";"
+#else
+#define WATCH_LIST_SEPARATOR ":"
+#endif
+
 // interval between the Windows and Unix epoch
 #define UNIX_EPOCH_IN_FILETIME 116444736000000000ULL
 
@@ -152,7 +162,9 @@ struct Studio
     struct
     {
         CartHash hash;
-        u64 mdate;
+        tic_fs_watch* watch;
+        char path[TICNAME_MAX];
+        bool changed;
     }cart;
 
     struct
@@ -204,13 +216,25 @@ struct Studio
         bool record;
         bool screenshot;
 
-        u32* buffer;
         s32 frame;
 
-        MsfGifState gif;
+        tic_recorder* recorder;
 
     } video;
 
+    struct
+    {
+        const char* video;
+        const char* audio;
+        s32 frames;
+
+        tic_capture* stream;
+        bool pending;
+
+        // read by the audio callback, set while the capture owns the samples buffer
+        u32 mute;
+    } capture;
+
     Code*       code;
 
     struct
@@ -229,9 +253,16 @@ struct Studio
 
     TicbuildRemoting* remoting;
     s32 remotingPort;
+    tb_carthash hashes;
 
     Bytebattle bytebattle;
 
+    struct
+    {
+        tic80_input input;
+        s32 frames;
+    } idle;
+
 #endif
 
     Start*      start;
@@ -243,6 +274,8 @@ struct Studio
 
     tic_fs* fs;
     s32 samplerate;
+    s32 audiobuffer;
+    tic80_pixel_color_format format;
     tic_font systemFont;
 
 };
@@ -349,6 +382,20 @@ static bool remoting_peek(void* userdata, uint32_t addr, uint32_t size, uint8_t*
     return true;
 }
 
+static bool remoting_audiotap(void* userdata, uint32_t channel, uint32_t count, int16_t* out, char* err, size_t errcap)
+{
+    Studio* studio = (Studio*)userdata;
+    if(!studio || !studio->tic) return false;
+
+    if(!tic_core_audiotap(studio->tic, (s32)channel, 0, out, (s32)count))
+    {
+        if(err && errcap) { strncpy(err, "invalid channel or count", errcap - 1); err[errcap - 1] = '\0'; }
+        return false;
+    }
+
+    return true;
+}
+
 static bool remoting_eval(void* userdata, const char* code, char* err, size_t errcap)
 {
     Studio* studio = (Studio*)userdata;
@@ -368,7 +415,9 @@ static bool remoting_eval(void* userdata, const char* code, char* err, size_t er
     const tic_script* script_config = tic_get_script(studio->tic);
     if(script_config && script_config->eval)
     {
+        // the script can sync anything back to the cart
         script_config->eval(studio->tic, code);
+        tb_carthash_invalidate(&studio->hashes, tb_hash_all);
         return true;
     }
 
@@ -401,7 +450,12 @@ static bool remoting_eval_expr(void* userdata, const char* expr, char* out, size
         return false;
     }
 
-    return tb_lua_eval_expr(studio->tic, expr, out, outcap, err, errcap);
+    bool ok = tb_lua_eval_expr(studio->tic, expr, out, outcap, err, errcap);
+
+    // the expression can call sync() too
+    tb_carthash_invalidate(&studio->hashes, tb_hash_all);
+
+    return ok;
 }
 
 static bool remoting_list_globals(void* userdata, char* out, size_t outcap, char* err, size_t errcap)
@@ -520,6 +574,21 @@ static bool remoting_metadata(void* userdata, const char* key, char* out, size_t
     out[outcap - 1] = '\0';
     return true;
 }
+
+static bool remoting_hashes(void* userdata, char* out, size_t outcap, char* err, size_t errcap)
+{
+    Studio* studio = (Studio*)userdata;
+
+    if(out && outcap) out[0] = '\0';
+
+    if(!studio || !studio->tic)
+    {
+        if(err && errcap) { strncpy(err, "hashes not available", errcap - 1); err[errcap - 1] = '\0'; }
+        return false;
+    }
+
+    return tb_carthash_list(&studio->hashes, &studio->tic->cart, out, outcap, err, errcap);
+}
 #endif
 
 void fadePalette(tic_palette* pal, s32 value)
@@ -572,114 +641,127 @@ static const tic_music* getMusicSrc(Studio* studio)
     return &tic->cart.banks[studio->bank.index.music].music;
 }
 
-const char* studioExportSfx(Studio* studio, s32 index, const char* filename)
+// makes "name-<index>-ch<channel>.wav" out of "name.wav", skipping negative parts,
+// fails if the result doesn't fit TICNAME_MAX
+static bool makeSoundPath(char* out, const char* path, s32 index, s32 channel)
 {
-    tic_mem* tic = studio->tic;
+    s32 len = (s32)strlen(path);
 
-    const char* path = tic_fs_path(studio->fs, filename);
+    if(tic_tool_has_ext(path, ".wav"))
+        len = MAX(len - (s32)STRLEN(".wav"), 0);
 
-    if(wave_open( studio->samplerate, path ))
-    {
+    char indexPart[16] = "", channelPart[16] = "";
 
-#if TIC80_SAMPLE_CHANNELS == 2
-        wave_enable_stereo();
-#endif
+    if(index >= 0)
+        snprintf(indexPart, sizeof indexPart, "-%i", index);
 
-        const tic_sfx* sfx = getSfxSrc(studio);
+    if(channel >= 0)
+        snprintf(channelPart, sizeof channelPart, "-ch%i", channel + 1);
 
-        sfx2ram(tic->ram, sfx);
-        music2ram(tic->ram, getMusicSrc(studio));
+    s32 size = snprintf(out, TICNAME_MAX, "%.*s%s%s.wav", len, path, indexPart, channelPart);
+    return size >= 0 && size < TICNAME_MAX;
+}
 
-        {
-            const tic_sample* effect = &sfx->samples.data[index];
+static s32 exportSound(tic_render_job* jobs, s32 count)
+{
+    return count && tic_render(jobs, count) == 0 ? count : -1;
+}
 
-            enum{Channel = 0};
-            sfx_stop(tic, Channel);
-            tic_api_sfx(tic, index, effect->note, effect->octave, -1, Channel, MAX_VOLUME, MAX_VOLUME, SFX_DEF_SPEED);
+s32 studioExportSfx(Studio* studio, s32 index, const char* filename, s32 samplerate)
+{
+    const tic_sfx* sfx = getSfxSrc(studio);
+    const char* path = tic_fs_path(studio->fs, filename);
+    bool all = index < 0;
 
-            for(s32 ticks = 0, pos = 0; pos < SFX_TICKS; pos = tic_tool_sfx_pos(effect->speed, ++ticks))
-            {
-                tic_core_tick_start(tic);
-                tic_core_tick_end(tic);
-                tic_core_synth_sound(tic);
+    tic_render_job jobs[SFX_COUNT];
+    s32 count = 0;
 
-                wave_write(tic->product.samples.buffer, tic->product.samples.count);
-            }
+    for(s32 i = all ? 0 : index, end = all ? SFX_COUNT : index + 1; i < end; i++)
+    {
+        static const tic_sample EmptySample;
 
-            sfx_stop(tic, Channel);
-            memset(tic->ram->registers, 0, sizeof(tic_sound_register));
-        }
+        // skip untouched sfx slots when exporting everything
+        if(all && MEMCMP(sfx->samples.data[i], EmptySample))
+            continue;
 
-        wave_close();
+        tic_render_job* job = &jobs[count++];
+        *job = (tic_render_job)
+        {
+            .type = tic_render_sfx,
+            .index = i,
+            .samplerate = samplerate > 0 ? samplerate : studio->samplerate,
+            .channels = (1 << TIC_SOUND_CHANNELS) - 1,
+            .sfx = sfx,
+            .music = getMusicSrc(studio),
+        };
 
-        return path;
+        if(!makeSoundPath(job->path, path, all ? i : -1, -1))
+            return -1;
     }
 
-    return NULL;
+    return exportSound(jobs, count);
 }
 
-const char* studioExportMusic(Studio* studio, s32 track, s32 bank, const char* filename)
+s32 studioExportMusic(Studio* studio, s32 track, s32 bank, const char* filename, s32 samplerate, bool stems, s32 frame, s32 row)
 {
-    tic_mem* tic = studio->tic;
-
-    const char* path = tic_fs_path(studio->fs, filename);
-
-    if(wave_open( studio->samplerate, path ))
-    {
-#if TIC80_SAMPLE_CHANNELS == 2
-        wave_enable_stereo();
-#endif
 #if defined(TIC80_PRO) && defined(BUILD_EDITORS)
-        // chained = true in CLI. Set to false if want to use unchained
-        bool chained = studio->bank.chained;
-        if(chained)
-            memset(studio->bank.indexes, bank, sizeof studio->bank.indexes);
-        else
-            for(s32 i = 0; i < COUNT_OF(BankModes); i++)
-                if(BankModes[i] == TIC_MUSIC_MODE)
-                    studio->bank.indexes[i] = bank;
+    // chained = true in CLI. Set to false if want to use unchained
+    bool chained = studio->bank.chained;
+    if(chained)
+        memset(studio->bank.indexes, bank, sizeof studio->bank.indexes);
+    else
+        for(s32 i = 0; i < COUNT_OF(BankModes); i++)
+            if(BankModes[i] == TIC_MUSIC_MODE)
+                studio->bank.indexes[i] = bank;
 #endif
-        const tic_sfx* sfx = getSfxSrc(studio);
-        const tic_music* music = getMusicSrc(studio);
-
-        sfx2ram(tic->ram, sfx);
-        music2ram(tic->ram, music);
 
-        const tic_music_state* state = &tic->ram->music_state;
-        const Music* editor = studio->banks.music[bank];
+    const tic_music* music = getMusicSrc(studio);
+    const Music* editor = studio->banks.music[bank];
+    const char* path = tic_fs_path(studio->fs, filename);
+    bool all = track < 0;
 
-        tic_api_music(tic, track, -1, -1, false, editor->sustain, -1, -1);
+    tic_render_job jobs[MUSIC_TRACKS * (TIC_SOUND_CHANNELS + 1)];
+    s32 count = 0;
 
-        s32 frame = state->music.frame;
-        s32 frames = MUSIC_FRAMES * 16;
+    u8 channels = 0;
+    for (s32 i = 0; i < TIC_SOUND_CHANNELS; i++)
+        if(editor->on[i])
+            channels |= 1 << i;
 
-        while(frames && state->flag.music_status == tic_music_play)
-        {
-            tic_core_tick_start(tic);
-
-            for (s32 i = 0; i < TIC_SOUND_CHANNELS; i++)
-                if(!editor->on[i])
-                    tic->ram->registers[i].volume = 0;
+    for(s32 i = all ? 0 : track, end = all ? MUSIC_TRACKS : track + 1; i < end; i++)
+    {
+        static const tic_track EmptyTrack;
 
-            tic_core_tick_end(tic);
-            tic_core_synth_sound(tic);
+        // skip tracks without any patterns when exporting everything
+        if(all && MEMCMP(music->tracks.data[i].data, EmptyTrack.data))
+            continue;
 
-            wave_write(tic->product.samples.buffer, tic->product.samples.count);
+        // the mix goes first, then one stem per audible channel
+        for(s32 channel = -1; channel < (stems ? TIC_SOUND_CHANNELS : 0); channel++)
+        {
+            if(channel >= 0 && !(channels & (1 << channel)))
+                continue;
 
-            if(frame != state->music.frame)
+            tic_render_job* job = &jobs[count++];
+            *job = (tic_render_job)
             {
-                --frames;
-                frame = state->music.frame;
-            }
+                .type = tic_render_music,
+                .index = i,
+                .samplerate = samplerate > 0 ? samplerate : studio->samplerate,
+                .channels = channel < 0 ? channels : 1 << channel,
+                .sustain = editor->sustain,
+                .frame = frame,
+                .row = row,
+                .sfx = getSfxSrc(studio),
+                .music = music,
+            };
+
+            if(!makeSoundPath(job->path, path, all ? i : -1, channel))
+                return -1;
         }
-
-        tic_api_music(tic, -1, -1, -1, false, false, -1, -1);
-
-        wave_close();
-        return path;
     }
 
-    return NULL;
+    return exportSound(jobs, count);
 }
 #endif
 
@@ -1289,6 +1371,8 @@ static void drawPopup(Studio* studio)
             for(s32 i = 0, y = 0; y < (Height + studio->anim.pos.popup); y++, dst += TIC80_MARGIN_RIGHT + TIC80_MARGIN_LEFT)
                 for(s32 x = 0; x < Width; x++)
                 *dst++ = tic_rgba(&bank->palette.vbank0.colors[tic_tool_peek4(tic->ram->vram.screen.data, i++)]);
+
+            tic_core_invalidate_rows(tic, TIC80_MARGIN_TOP, Height + studio->anim.pos.popup);
         }
     }
 }
@@ -1783,7 +1867,18 @@ static void updateHash(Studio* studio)
 
 static void updateMDate(Studio* studio)
 {
-    studio->cart.mdate = fs_date(studio->console->rom.path);
+    const char* path = studio->console->rom.path;
+
+    if(strcmp(studio->cart.path, path))
+    {
+        tic_fs_watch_remove(studio->cart.watch, studio->cart.path);
+        tic_fs_watch_add(studio->cart.watch, path);
+        strcpy(studio->cart.path, path);
+    }
+
+    // ignore our own writes
+    tic_fs_watch_skip(studio->cart.watch);
+    studio->cart.changed = false;
 }
 #endif
 
@@ -1835,6 +1930,7 @@ void studioRomSaved(Studio* studio)
 void studioRomLoaded(Studio* studio)
 {
     initModules(studio);
+    tb_carthash_invalidate(&studio->hashes, tb_hash_all);
 
     updateTitle(studio);
     updateHash(studio);
@@ -1860,10 +1956,10 @@ void runGame(Studio* studio)
         fPeakSmoothing = 0.995f;
         fPeakSmoothValue = 0.0f;
         fAmplification = 1.0f;
-        memset(fftData, 0, sizeof(fftData[0]) * FFT_SIZE);
-        memset(fftSmoothingData, 0, sizeof(fftSmoothingData[0]) * FFT_SIZE);
-        memset(fftNormalizedData, 0, sizeof(fftNormalizedData[0]) * FFT_SIZE);
-        memset(fftNormalizedMaxData, 0, sizeof(fftNormalizedMaxData[0]) * FFT_SIZE);
+        memset(fftData, 0, sizeof fftData);
+        memset(fftSmoothingData, 0, sizeof fftSmoothingData);
+        memset(fftNormalizedData, 0, sizeof fftNormalizedData);
+        memset(fftNormalizedMaxData, 0, sizeof fftNormalizedMaxData);
     }
 
     if(studio->console->args.keepcmd
@@ -2006,13 +2102,15 @@ static void generateScreenshotName(Studio* studio, const char* extension, char f
 
 static void stopVideoRecord(Studio* studio)
 {
-    MsfGifResult result = msf_gif_end(&studio->video.gif);
+    s32 size = 0;
+    void* data = tic_recorder_finish(studio->video.recorder, &size);
+    studio->video.recorder = NULL;
 
     char filename[TICNAME_MAX];
     generateScreenshotName(studio, ".gif", filename);
 
     // Now that it has found an available filename, save it.
-    if(tic_fs_save(studio->fs, filename, result.data, result.dataSize, true))
+    if(tic_fs_save(studio->fs, filename, data, size, true))
     {
         char msg[TICNAME_MAX];
         sprintf(msg, "%s saved :)", filename);
@@ -2022,7 +2120,7 @@ static void stopVideoRecord(Studio* studio)
     }
     else showPopupMessage(studio, "error: file not saved :(");
 
-    msf_gif_free(result);
+    free(data);
 
     studio->video.record = false;
 }
@@ -2038,8 +2136,8 @@ static void startVideoRecord(Studio* studio)
         studio->video.record = true;
         studio->video.frame = 0;
 
-        s32 scale = studio->config->data.uiScale;
-        msf_gif_begin(&studio->video.gif, TIC80_FULLWIDTH * scale, TIC80_FULLHEIGHT * scale);
+        // every second frame is recorded
+        studio->video.recorder = tic_recorder_start(studio->config->data.uiScale, TIC80_FRAMERATE / 2);
     }
 }
 
@@ -2296,6 +2394,15 @@ static void reloadConfirm(Studio* studio, bool yes, void* data)
         updateMDate(studio);
 }
 
+static void onWatchChanged(const char* path, void* data)
+{
+    Studio* studio = data;
+
+    // dependencies only matter when the cart itself came from a file
+    if(fs_exists(studio->cart.path))
+        studio->cart.changed = true;
+}
+
 static void checkChanges(Studio* studio)
 {
     switch(studio->mode)
@@ -2306,12 +2413,17 @@ static void checkChanges(Studio* studio)
         {
             Console* console = studio->console;
 
-            u64 date = fs_date(console->rom.path);
+            tic_fs_watch_poll(studio->cart.watch, onWatchChanged, studio);
 
-            if(studio->cart.mdate && date > studio->cart.mdate)
+            if(studio->cart.changed)
             {
-                if(studioCartChanged(studio) && studio->mode != TIC_MENU_MODE)
+                if(studioCartChanged(studio))
                 {
+                    if(studio->mode == TIC_MENU_MODE)
+                        break;
+
+                    studio->cart.changed = false;
+
                     static const char* Rows[] =
                     {
                         "WARNING!",
@@ -2321,7 +2433,11 @@ static void checkChanges(Studio* studio)
 
                     confirmDialog(studio, Rows, COUNT_OF(Rows), reloadConfirm, NULL);
                 }
-                else console->updateProject(console);
+                else
+                {
+                    studio->cart.changed = false;
+                    console->updateProject(console);
+                }
             }
         }
     }
@@ -2344,6 +2460,151 @@ static void drawRecordLabel(Studio* studio, u32* frame, s32 sx, s32 sy)
     drawBitIconRaw(studio, frame, sx + TIC_SPRITESIZE, sy, tic_icon_rec2, tic_color_red);
 }
 
+static bool isStudioBusy(Studio* studio)
+{
+    tic_mem* tic = studio->tic;
+    const tic80_input* input = &tic->ram->input;
+
+    switch(studio->mode)
+    {
+    case TIC_CODE_MODE:
+    case TIC_SPRITE_MODE:
+    case TIC_MAP_MODE:
+    case TIC_WORLD_MODE:
+    case TIC_SFX_MODE:
+    case TIC_MUSIC_MODE:
+        break;
+    default:
+        return true;
+    }
+
+    if(studio->toolbarMode
+        || studio->anim.movie != &studio->anim.idle
+        || studio->video.record
+        || studio->bytebattle.exp
+        || studio->bytebattle.imp
+        || studio->bytebattle.battle.started)
+        return true;
+
+    if(input->keyboard.data || input->gamepads.data || input->mouse.btns
+        || !MEMCMP(*input, studio->idle.input))
+        return true;
+
+    if(tic->ram->music_state.flag.music_status != tic_music_stop)
+        return true;
+
+    for(s32 i = 0; i < TIC_SOUND_CHANNELS; ++i)
+        if(tic->ram->registers[i].volume || tic->ram->sfxpos[i].wave >= 0)
+            return true;
+
+    return false;
+}
+
+static bool isCaptureFrame(Studio* studio)
+{
+    return studio->capture.video || studio->capture.audio;
+}
+
+// the synth plays the previous tick, so the sound of a captured frame is written on the next one
+static void captureSound(Studio* studio)
+{
+    tic_mem* tic = studio->tic;
+    tic_core_synth_sound(tic);
+
+    if(studio->capture.pending)
+        tic_capture_audio(studio->capture.stream, tic->product.samples.buffer, tic->product.samples.count);
+}
+
+static void stopCapture(Studio* studio)
+{
+    if(studio->capture.stream)
+    {
+        if(studio->capture.audio)
+            captureSound(studio);
+
+        tic_capture_close(studio->capture.stream);
+        studio->capture.stream = NULL;
+    }
+
+    studio->capture.video = studio->capture.audio = NULL;
+    STORE_RELEASE(studio->capture.mute, 0);
+}
+
+// every frame of the running game is written, paused frames are skipped
+static void captureFrame(Studio* studio)
+{
+    tic_mem* tic = studio->tic;
+    bool run = studio->mode == TIC_RUN_MODE;
+
+    if(!studio->capture.stream)
+    {
+        if(!run)
+            return;
+
+        // no audio device in the console only mode, the sample rate comes from the options
+        s32 samplerate = getConfig(studio)->options.samplerate;
+        if(getConfig(studio)->cli && samplerate > 0)
+            studio_audiospec(studio, samplerate, studio->audiobuffer);
+
+        studio->capture.stream = tic_capture_open(studio->capture.video, studio->capture.audio, studio->samplerate, studio->format);
+
+        if(!studio->capture.stream)
+        {
+            fprintf(stderr, "error: can't open the capture output\n");
+            stopCapture(studio);
+            return;
+        }
+
+        tic_core_sound_flush(tic);
+    }
+    else if(studio->capture.audio)
+        captureSound(studio);
+
+    studio->capture.pending = run;
+
+    if(run)
+    {
+        tic_capture_video(studio->capture.stream, tic->product.screen);
+
+        if(studio->capture.frames && --studio->capture.frames == 0)
+        {
+            stopCapture(studio);
+            exitStudio(studio);
+        }
+    }
+}
+
+static void updateIdle(Studio* studio)
+{
+    studio->idle.frames = isStudioBusy(studio) ? 0 : studio->idle.frames + 1;
+    studio->idle.input = studio->tic->ram->input;
+}
+
+// editors only write the cart on input and only their own sections, anything else
+// (a running game, console commands from --cmd or a script) can write any section
+static void invalidateHashes(Studio* studio, EditorMode mode)
+{
+    const tic80_input* input = &studio->tic->ram->input;
+    bool touched = input->keyboard.data || input->gamepads.data || input->mouse.btns;
+    u32 mask = 0;
+
+    switch(mode)
+    {
+    case TIC_CODE_MODE:     mask = tb_hash_code; break;
+    case TIC_SPRITE_MODE:   mask = tic_sync_tiles | tic_sync_sprites | tic_sync_flags | tic_sync_palette; break;
+    case TIC_MAP_MODE:
+    case TIC_WORLD_MODE:    mask = tic_sync_map; break;
+    case TIC_SFX_MODE:      mask = tic_sync_sfx; break;
+    case TIC_MUSIC_MODE:    mask = tic_sync_music; break;
+    default:
+        tb_carthash_invalidate(&studio->hashes, tb_hash_all);
+        return;
+    }
+
+    if(touched)
+        tb_carthash_invalidate(&studio->hashes, mask);
+}
+
 static bool isRecordFrame(Studio* studio)
 {
     return studio->video.record;
@@ -2353,21 +2614,9 @@ static void recordFrame(Studio* studio, u32* pixels)
 {
     if(studio->video.record)
     {
+        // the frame is scaled and encoded on the recorder thread
         if(studio->video.frame % 2 == 0)
-        {
-            s32 scale = studio->config->data.uiScale;
-            s32 w = TIC80_FULLWIDTH * scale;
-            s32 h = TIC80_FULLHEIGHT * scale;
-
-            u32 *ptr = studio->video.buffer;
-            const u32 *src = pixels;
-            for(s32 y = 0; y < h; y++, src = pixels + (y / scale) * TIC80_FULLWIDTH)
-                for(s32 x = 0; x < w; x++)
-                    *ptr++ = src[x / scale];
-
-            // with centiSecondsPerFame == 3 we have 1000/(3*10)=~33.3fps, so we have to save every second frame
-            msf_gif_frame(&studio->video.gif, (u8*)studio->video.buffer, 3, 16, w * sizeof(u32));
-        }
+            tic_recorder_frame(studio->video.recorder, pixels);
 
         if(studio->video.screenshot)
         {
@@ -2379,6 +2628,7 @@ static void recordFrame(Studio* studio, u32* pixels)
         if(studio->video.frame % TIC80_FRAMERATE < TIC80_FRAMERATE / 2)
         {
             drawRecordLabel(studio, pixels, TIC80_WIDTH - 24, 8);
+            tic_core_invalidate_rows(studio->tic, 8, TIC_SPRITESIZE);
         }
 
         studio->video.frame++;
@@ -2547,9 +2797,6 @@ void studioConfigChanged(Studio* studio)
     Code* code = studio->code;
     if(code->update)
         code->update(code);
-
-    s32 scale = studio->config->data.uiScale;
-    studio->video.buffer = realloc(studio->video.buffer, TIC80_FULLWIDTH * scale * TIC80_FULLHEIGHT * scale * sizeof(u32));
 #endif
 
     updateSystemFont(studio);
@@ -2717,6 +2964,8 @@ static void blitCursor(Studio* studio)
                     if(c)
                         *dst = tic_rgba(&pal->colors[c]);
                 }
+
+        tic_core_invalidate_rows(tic, s.y, TIC_SPRITESIZE);
     }
 }
 
@@ -2730,20 +2979,38 @@ const tic_mem* studio_mem(Studio* studio)
     return getMemory(studio);
 }
 
+#if defined(BUILD_EDITORS)
+// queued sound plus the device buffer, in 0.1ms
+static u32 getAudioLatency(Studio* studio)
+{
+    return (u32)((s64)(tic_core_sound_latency(studio->tic) + studio->audiobuffer) * 10000 / studio->samplerate);
+}
+#endif
+
 void studio_tick(Studio* studio, tic80_input input)
 {
     tic_mem* tic = studio->tic;
     tic->ram->input = input;
 
 #if defined(BUILD_EDITORS)
-    if(studio->remoting)
-    {
-        ticbuild_remoting_tick(studio->remoting);
-    }
+    // the socket is pumped on every wakeup, a command can change anything so it ends the idle
+    if(studio->remoting && ticbuild_remoting_tick(studio->remoting))
+        studio->idle.frames = 0;
 
     processAnim(studio->anim.movie, studio);
     checkChanges(studio);
     tic_net_start(studio->net);
+
+    updateIdle(studio);
+    EditorMode mode = studio->mode;
+
+    // nothing can change on screen, keep the last frame
+    if(studio_idle(studio))
+    {
+        ZEROMEM(tic->product.dirty);
+        tic_net_end(studio->net);
+        return;
+    }
 #endif
 
     if(studio->toolbarMode)
@@ -2784,6 +3051,11 @@ void studio_tick(Studio* studio, tic80_input input)
             : tic_core_blit(tic);
 
 #if defined(BUILD_EDITORS)
+        invalidateHashes(studio, mode);
+
+        if(studio->mode != mode)
+            invalidateHashes(studio, studio->mode);
+
         if(studio->remoting)
         {
             uint32_t tic_ms10 = 0, scn_ms10 = 0, bdr_ms10 = 0, tot_ms10 = 0;
@@ -2797,6 +3069,7 @@ void studio_tick(Studio* studio, tic80_input input)
             }
 
             ticbuild_remoting_set_user_time_ms10(studio->remoting, tic_ms10, scn_ms10, bdr_ms10, tot_ms10);
+            ticbuild_remoting_set_audio_latency_ms10(studio->remoting, getAudioLatency(studio));
             ticbuild_remoting_on_frame(studio->remoting, tic_sys_counter_get(), tic_sys_freq_get());
 
             if(ticbuild_remoting_take_title_dirty(studio->remoting)) {
@@ -2811,6 +3084,9 @@ void studio_tick(Studio* studio, tic80_input input)
         if(isRecordFrame(studio))
             recordFrame(studio, tic->product.screen);
 
+        if(isCaptureFrame(studio))
+            captureFrame(studio);
+
         drawPopup(studio);
 #endif
     }
@@ -2844,16 +3120,52 @@ void studio_tick(Studio* studio, tic80_input input)
         if(bb->exp)
             doCodeExport(studio);
         else if(bb->imp)
+        {
             doCodeImport(studio);
+            tb_carthash_invalidate(&studio->hashes, tb_hash_code);
+        }
 
         bb->ticks = 0;
     }
 #endif
 }
 
-void studio_sound(Studio* studio)
+bool studio_idle(Studio* studio)
+{
+#if defined(BUILD_EDITORS)
+    return studio->idle.frames >= STUDIO_IDLE_FRAMES;
+#else
+    return false;
+#endif
+}
+
+void studio_audiospec(Studio* studio, s32 samplerate, s32 buffer)
+{
+    if(samplerate > 0 && samplerate != studio->samplerate)
+    {
+        studio->samplerate = samplerate;
+        tic_core_samplerate(studio->tic, samplerate);
+    }
+
+    studio->audiobuffer = buffer;
+
+    // every device callback synthesizes as many ticks as fit in its buffer
+    s32 frame = studio->samplerate / TIC80_FRAMERATE;
+    if(buffer > 0 && frame > 0)
+        tic_core_sound_burst(studio->tic, (buffer + frame - 1) / frame);
+}
+
+bool studio_sound(Studio* studio)
 {
     tic_mem* tic = studio->tic;
+
+#if defined(BUILD_EDITORS)
+    // the capture synthesizes every frame on the main thread into the same buffer,
+    // so the device plays silence instead of reading it
+    if(LOAD_ACQUIRE(studio->capture.mute))
+        return false;
+#endif
+
     tic_core_synth_sound(tic);
 
     s32 volume = getConfig(studio)->options.volume;
@@ -2864,6 +3176,8 @@ void studio_sound(Studio* studio)
         for(s16* it = tic->product.samples.buffer, *end = it + size; it != end; ++it)
             *it = *it * volume / MAX_VOLUME;
     }
+
+    return true;
 }
 
 #if defined(BUILD_EDITORS)
@@ -2949,11 +3263,23 @@ void studio_delete(Studio* studio)
         studio_menu_free(studio->menu);
     }
 
+#if defined(BUILD_EDITORS)
+    // the last frame of sound is synthesized on close
+    stopCapture(studio);
+#endif
+
     tic_core_close(studio->tic);
 
 #if defined(BUILD_EDITORS)
     tic_net_close(studio->net);
-    free(studio->video.buffer);
+    tic_fs_watch_delete(studio->cart.watch);
+
+    if(studio->video.recorder)
+    {
+        s32 size;
+        free(tic_recorder_finish(studio->video.recorder, &size));
+    }
+
     if(studio->bytebattle.exp) free(studio->bytebattle.exp);
     if(studio->bytebattle.imp) free(studio->bytebattle.imp);
 #endif
@@ -2979,6 +3305,7 @@ static StartArgs parseArgs(s32 argc, char **argv)
 
     StartArgs args = {0};
     args.volume = -1;
+    args.samplerate = -1;
     args.remotingPort = 0;
 
 #if defined(BUILD_EDITORS)
@@ -2996,6 +3323,7 @@ static StartArgs parseArgs(s32 argc, char **argv)
 #if defined(BUILD_EDITORS)
 
         OPT_INTEGER('\0', "remoting-port", &args.remotingPort, "listen on 127.0.0.1:<port> for ticbuild remoting"),
+        OPT_STRING('\0', "watch", &args.watch, "reload the cart when any of these files change (" WATCH_LIST_SEPARATOR " separated)"),
 
         OPT_GROUP("Byte battle options:\n"),
         OPT_STRING('\0',    "codeexport",    &args.codeexport,   "export code to filename"),
@@ -3004,11 +3332,18 @@ static StartArgs parseArgs(s32 argc, char **argv)
         OPT_INTEGER('\0',   "lowerlimit",    &args.lowerlimit,   "lower limit for code size (256 by default)"),
         OPT_INTEGER('\0',   "upperlimit",    &args.upperlimit,   "upper limit for code size (512 by default)"),
         OPT_INTEGER('\0',   "battletime",    &args.battletime,   "battletime in minutes"),
+        OPT_GROUP("Capture options:\n"),
+        OPT_STRING('\0', "capture", &args.capture, "stream every frame of the game as raw RGBA, or Y4M if the file ends with .y4m"),
+        OPT_STRING('\0', "captureaudio", &args.captureaudio, "stream the game sound as raw 16-bit stereo PCM, or WAV if the file ends with .wav"),
+        OPT_INTEGER('\0', "captureframes", &args.captureframes, "exit after capturing this many frames"),
         OPT_GROUP("FFT options:\n"),
         OPT_BOOLEAN('\0', "fft", &args.fft, "enable FFT support"),
         OPT_BOOLEAN('\0', "fftlist", &args.fftlist, "list FFT devices"),
         OPT_BOOLEAN('\0', "fftcaptureplaybackdevices", &args.fftcaptureplaybackdevices, "Capture playback devices for loopback (Windows only)"),
         OPT_STRING('\0', "fftdevice", &args.fftdevice, "name of the device to use with FFT"),
+        OPT_INTEGER('\0', "fftsize", &args.fftsize, "number of FFT bins, power of two [256-4096]"),
+        OPT_STRING('\0', "fftwindow", &args.fftwindow, "FFT window function (none, hann, blackman)"),
+        OPT_INTEGER('\0', "ffthop", &args.ffthop, "captured samples between FFT updates (default fftsize/2)"),
 #endif
         OPT_END(),
     };
@@ -3108,6 +3443,11 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
 #if defined(BUILD_EDITORS)
         .menuMode = TIC_CONSOLE_MODE,
 
+        .cart =
+        {
+            .watch = tic_fs_watch_create(),
+        },
+
         .bank =
         {
             .chained = true,
@@ -3132,7 +3472,6 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
             .text = "\0",
         },
 
-        .samplerate = samplerate,
         .net = tic_net_create(TIC_WEBSITE),
 
         .remoting = NULL,
@@ -3140,6 +3479,8 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
 
         .bytebattle = {0},
 #endif
+        .samplerate = samplerate,
+        .format = format,
         .tic = tic_core_create(samplerate, format),
     };
 
@@ -3230,12 +3571,14 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
             .sync = remoting_sync,
             .poke = remoting_poke,
             .peek = remoting_peek,
+            .audiotap = remoting_audiotap,
             .eval = remoting_eval,
             .eval_expr = remoting_eval_expr,
             .list_globals = remoting_list_globals,
             .cart_path = remoting_cart_path,
             .fs_path = remoting_fs_path,
             .metadata = remoting_metadata,
+            .hashes = remoting_hashes,
         };
 
         studio->remoting = ticbuild_remoting_create(studio->remotingPort, &cb);
@@ -3251,6 +3594,18 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
     if(args.volume >= 0)
         studio->config->data.options.volume = args.volume & 0x0f;
 
+    if(args.samplerate >= 0)
+        studio->config->data.options.samplerate = args.samplerate;
+
+    if(args.audiobuffer > 0)
+        studio->config->data.options.audioBuffer = args.audiobuffer;
+
+    if(args.audiolatency > 0)
+        studio->config->data.options.audioLatency = args.audiolatency;
+
+    if(studio->config->data.options.audioLatency > 0)
+        tic_core_sound_target(studio->tic, studio->config->data.options.audioLatency);
+
 #if defined(CRT_SHADER_SUPPORT)
     studio->config->data.options.crt        |= args.crt;
 #endif
@@ -3266,6 +3621,16 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
     else if(args.codeimport)
         studio->bytebattle.imp = strdup(args.codeimport);
 
+    if(args.watch)
+    {
+        char* list = strdup(args.watch);
+
+        for(char* path = strtok(list, WATCH_LIST_SEPARATOR); path; path = strtok(NULL, WATCH_LIST_SEPARATOR))
+            tic_fs_watch_add(studio->cart.watch, path);
+
+        free(list);
+    }
+
     studio->bytebattle.delay = args.delay;
     studio->bytebattle.limit.lower = args.lowerlimit;
 
@@ -3282,9 +3647,17 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
         FFT_EnumerateDevices();
         exit(0);
     }
+    studio->capture.video = args.capture;
+    studio->capture.audio = args.captureaudio;
+    studio->capture.mute = args.captureaudio != NULL;
+    studio->capture.frames = args.captureframes;
+
     studio->config->data.fft = args.fft;
     studio->config->data.fftcaptureplaybackdevices = args.fftcaptureplaybackdevices;
     studio->config->data.fftdevice = args.fftdevice;
+    studio->config->data.fftsize = args.fftsize;
+    studio->config->data.fftwindow = args.fftwindow;
+    studio->config->data.ffthop = args.ffthop;
     studio->config->data.keyboardLayout = keyboardLayout;
 #endif
 
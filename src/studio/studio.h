@@ -79,6 +79,9 @@
     macro(cli,          int,    BOOLEAN,    "",         "console only output")              \
     macro(fullscreen,   int,    BOOLEAN,    "",         "enable fullscreen mode")           \
     macro(vsync,        int,    BOOLEAN,    "",         "enable VSYNC")                     \
+    macro(samplerate,   s32,    INTEGER,    "=<int>",   "audio sample rate (0 - native)")   \
+    macro(audiobuffer,  s32,    INTEGER,    "=<int>",   "audio buffer size in samples")     \
+    macro(audiolatency, s32,    INTEGER,    "=<int>",   "audio queue in ticks [1-10]")      \
     macro(soft,         int,    BOOLEAN,    "",         "use software rendering")           \
     macro(fs,           char*,  STRING,     "=<str>",   "path to the file system folder")   \
     macro(scale,        s32,    INTEGER,    "=<int>",   "main window scale")                \
@@ -105,6 +108,7 @@ typedef struct
     s32 remotingPort;
 
 #if defined(BUILD_EDITORS)
+    const char *watch;
     const char *codeexport;
     const char *codeimport;
     s32 delay;
@@ -112,10 +116,17 @@ typedef struct
     s32 upperlimit;
     s32 battletime;
 
+    const char *capture;
+    const char *captureaudio;
+    int captureframes;
+
     int fft;
     int fftlist;
     int fftcaptureplaybackdevices;
     const char *fftdevice;
+    int fftsize;
+    const char *fftwindow;
+    int ffthop;
 #endif
 } StartArgs;
 
@@ -289,8 +300,9 @@ const StudioConfig* getConfig(Studio* studio);
 struct Start* getStartScreen(Studio* studio);
 struct Sprite* getSpriteEditor(Studio* studio);
 
-const char* studioExportMusic(Studio* studio, s32 track, s32 bank, const char* filename);
-const char* studioExportSfx(Studio* studio, s32 sfx, const char* filename);
+// negative track/sfx exports all of them, returns the number of files written or -1
+s32 studioExportMusic(Studio* studio, s32 track, s32 bank, const char* filename, s32 samplerate, bool stems, s32 frame, s32 row);
+s32 studioExportSfx(Studio* studio, s32 sfx, const char* filename, s32 samplerate);
 
 tic_mem* getMemory(Studio* studio);
 
@@ -136,6 +136,9 @@ typedef struct
         bool vsync;
         bool integerScale;
         s32 volume;
+        s32 samplerate;
+        s32 audioBuffer;
+        s32 audioLatency;
         bool autosave;
         tic_mapping mapping;
 #if defined(BUILD_EDITORS)
@@ -152,6 +155,9 @@ typedef struct
     int fft;
     int fftcaptureplaybackdevices;
     const char *fftdevice;
+    int fftsize;
+    const char *fftwindow;
+    int ffthop;
 
     tic_layout keyboardLayout;
 } StudioConfig;
@@ -162,10 +168,13 @@ void setJustSwitchedToCodeMode(Studio* studio, bool value);
 bool hasJustSwitchedToCodeMode(Studio* studio);
 const tic_mem* studio_mem(Studio* studio);
 void studio_tick(Studio* studio, tic80_input input);
-void studio_sound(Studio* studio);
+// false when there is nothing to play, the samples buffer is the capture's then
+bool studio_sound(Studio* studio);
 void studio_load(Studio* studio, const char* file);
 void studio_keymapchanged(Studio *studio, tic_layout keyboardLayout);
 bool studio_alive(Studio* studio);
+bool studio_idle(Studio* studio);
+void studio_audiospec(Studio* studio, s32 samplerate, s32 buffer);
 void studio_exit(Studio* studio);
 void studio_delete(Studio* studio);
 const StudioConfig* studio_config(Studio* studio);
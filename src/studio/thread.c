@@ -0,0 +1,134 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "thread.h"
+
+#include <stdlib.h>
+
+#if defined(__TIC_WINDOWS__)
+#include <windows.h>
+#define TIC_THREADS
+#elif !defined(__EMSCRIPTEN__) && !defined(BAREMETALPI) && !defined(__3DS__)
+#include <pthread.h>
+#include <unistd.h>
+#define TIC_THREADS
+#endif
+
+struct tic_thread
+{
+    tic_thread_func func;
+    void* data;
+
+#if defined(__TIC_WINDOWS__)
+    HANDLE handle;
+#elif defined(TIC_THREADS)
+    pthread_t handle;
+#endif
+};
+
+#if defined(__TIC_WINDOWS__)
+static DWORD WINAPI threadProc(LPVOID data)
+{
+    tic_thread* thread = data;
+    thread->func(thread->data);
+    return 0;
+}
+#elif defined(TIC_THREADS)
+static void* threadProc(void* data)
+{
+    tic_thread* thread = data;
+    thread->func(thread->data);
+    return NULL;
+}
+#endif
+
+tic_thread* tic_thread_create(tic_thread_func func, void* data)
+{
+#if defined(TIC_THREADS)
+    tic_thread* thread = malloc(sizeof(tic_thread));
+
+    if(thread)
+    {
+        thread->func = func;
+        thread->data = data;
+
+#if defined(__TIC_WINDOWS__)
+        if((thread->handle = CreateThread(NULL, 0, threadProc, thread, 0, NULL)))
+            return thread;
+#else
+        if(pthread_create(&thread->handle, NULL, threadProc, thread) == 0)
+            return thread;
+#endif
+
+        free(thread);
+    }
+#endif
+
+    return NULL;
+}
+
+tic_thread* tic_thread_start(tic_thread_func func, void* data)
+{
+    tic_thread* thread = tic_thread_create(func, data);
+
+    if(!thread)
+        func(data);
+
+    return thread;
+}
+
+void tic_thread_join(tic_thread* thread)
+{
+    if(!thread)
+        return;
+
+#if defined(__TIC_WINDOWS__)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#elif defined(TIC_THREADS)
+    pthread_join(thread->handle, NULL);
+#endif
+
+    free(thread);
+}
+
+s32 tic_thread_cores()
+{
+#if defined(__TIC_WINDOWS__)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (s32)info.dwNumberOfProcessors;
+#elif defined(TIC_THREADS)
+    return (s32)sysconf(_SC_NPROCESSORS_ONLN);
+#else
+    return 1;
+#endif
+}
+
+void tic_thread_sleep(s32 ms)
+{
+#if defined(__TIC_WINDOWS__)
+    Sleep(ms);
+#elif defined(TIC_THREADS)
+    usleep(ms * 1000);
+#endif
+}
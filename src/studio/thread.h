@@ -0,0 +1,45 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tic.h"
+
+// worker threads for the studio, on platforms without threads (or when a
+// thread can't be created) the work can fall back to the calling thread
+
+typedef struct tic_thread tic_thread;
+typedef void(*tic_thread_func)(void* data);
+
+// runs func(data) on a new thread, NULL if it can't be started
+tic_thread* tic_thread_create(tic_thread_func func, void* data);
+
+// same, but runs func(data) right here and returns NULL if the thread can't be started
+tic_thread* tic_thread_start(tic_thread_func func, void* data);
+
+// waits for the thread to finish and frees it, NULL is ignored
+void tic_thread_join(tic_thread* thread);
+
+// threads worth starting for parallel work, 1 without thread support
+s32 tic_thread_cores();
+
+void tic_thread_sleep(s32 ms);
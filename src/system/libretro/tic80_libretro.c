@@ -78,6 +78,8 @@ struct tic80_state
 	int mouseHideTimerStart;
 	tic80* tic;
 	retro_usec_t frameTime;
+	bool canDupe;
+	bool forceVideo;
 };
 static struct tic80_state* state = NULL;
 
@@ -861,6 +863,9 @@ void tic80_libretro_mousecursor(tic80* game, tic80_mouse* mouse, enum mouse_curs
 		}
 		break;
 	}
+
+	// the cursor spans at most 4 rows around the mouse position
+	tic_core_invalidate_rows(tic, my + TIC80_OFFSET_TOP - 4, 9);
 }
 
 /**
@@ -926,6 +931,24 @@ void tic80_libretro_draw(tic80* game)
 	// Render the mouse cursor if needed.
 	tic80_libretro_mousecursor((tic80*)game, &state->input.mouse, state->mouseCursor);
 
+	// Let the frontend reuse the previous frame if no visible row has changed.
+	if (state->canDupe && !state->forceVideo) {
+		s32 first = state->cropBorder ? TIC80_OFFSET_TOP : 0;
+		s32 last = state->cropBorder ? TIC80_OFFSET_TOP + TIC80_HEIGHT : TIC80_FULLHEIGHT;
+		bool dirty = false;
+
+		for (s32 row = first; row < last && !dirty; row++)
+			dirty = TIC80_ROW_DIRTY(game, row);
+
+		if (!dirty) {
+			video_cb(NULL, state->cropBorder ? TIC80_WIDTH : TIC80_FULLWIDTH,
+				state->cropBorder ? TIC80_HEIGHT : TIC80_FULLHEIGHT, TIC80_FULLWIDTH << 2);
+			return;
+		}
+	}
+
+	state->forceVideo = false;
+
 	// Render to the screen.
 	if (state->cropBorder) {
 		u32 *screen = (u32*)game->screen + (TIC80_FULLWIDTH * TIC80_OFFSET_TOP) + TIC80_OFFSET_LEFT;
@@ -967,6 +990,10 @@ void tic80_libretro_variables(bool startup)
 		}
 	}
 
+	if (state->cropBorder != lastCropBorder) {
+		state->forceVideo = true;
+	}
+
 	if (!startup && (state->cropBorder != lastCropBorder)) {
 		struct retro_system_av_info av_info;
 		retro_get_system_av_info(&av_info);
@@ -1104,6 +1131,11 @@ RETRO_API bool retro_load_game(const struct retro_game_info *info)
 		return false;
 	}
 
+	// Frame duping lets unchanged frames skip the video upload.
+	state->canDupe = false;
+	environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &state->canDupe);
+	state->forceVideo = true;
+
 	// Check for the content.
 	if (info == NULL) {
 		log_cb(RETRO_LOG_ERROR, "[TIC-80] No content information provided.\n");
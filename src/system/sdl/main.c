@@ -57,6 +57,8 @@ extern void gotoMenu(Studio* studio);
 #define TEXTURE_SIZE (TIC80_FULLWIDTH)
 #define SCREEN_FORMAT TIC80_PIXEL_COLOR_RGBA8888
 #define AXIS_THRESHOLD 0x4000
+#define IDLE_TIMEOUT 100 // ms to wait for events while the studio is idle
+#define AUDIO_BUFFER_SIZE 1024 // default device buffer in samples
 
 #if defined(__TIC_WINDOWS__)
 #include <windows.h>
@@ -75,7 +77,6 @@ extern void gotoMenu(Studio* studio);
 #define KBD_COLS 22
 #define KBD_ROWS 17
 
-#define LOCK_MUTEX(MUTEX) SDL_LockMutex(MUTEX); SCOPE(SDL_UnlockMutex(MUTEX))
 
 enum
 {
@@ -111,6 +112,9 @@ static struct
         Renderer renderer;
         Texture texture;
 
+        // the texture content is lost, upload the whole screen
+        bool invalid;
+
 #if defined(CRT_SHADER_SUPPORT)
         u32 shader;
         GPU_ShaderBlock block;
@@ -185,9 +189,9 @@ static struct
 
     struct
     {
-        SDL_mutex           *mutex;
         SDL_AudioSpec       spec;
         SDL_AudioDeviceID   device;
+        s32                 bufferSize;
         s32                 bufferRemaining;
     } audio;
 
@@ -292,45 +296,63 @@ static void renderCopy(Renderer render, Texture tex, SDL_Rect src, SDL_Rect dst)
     }
 }
 
+// runs on the audio thread without locking the studio, the core hands over
+// the sound registers through its lock-free ring buffer
 static void audioCallback(void* userdata, u8* stream, s32 len)
 {
-    LOCK_MUTEX(platform.audio.mutex)
-    {
-        const tic_mem* tic = studio_mem(platform.studio);
+    const tic_mem* tic = studio_mem(platform.studio);
 
-        while(len--)
+    while(len > 0)
+    {
+        // frame length varies by a sample when the rate isn't a multiple of the frame rate
+        if (platform.audio.bufferRemaining <= 0)
         {
-            if (platform.audio.bufferRemaining <= 0)
+            if(!studio_sound(platform.studio))
             {
-                studio_sound(platform.studio);
-                platform.audio.bufferRemaining = tic->product.samples.count * TIC80_SAMPLESIZE;
+                memset(stream, 0, len);
+                return;
             }
 
-            *stream++ = ((u8*)tic->product.samples.buffer)[tic->product.samples.count * TIC80_SAMPLESIZE - platform.audio.bufferRemaining--];
+            platform.audio.bufferSize = platform.audio.bufferRemaining = tic->product.samples.count * TIC80_SAMPLESIZE;
         }
+
+        s32 chunk = MIN(len, platform.audio.bufferRemaining);
+        memcpy(stream, (u8*)tic->product.samples.buffer + platform.audio.bufferSize - platform.audio.bufferRemaining, chunk);
+
+        stream += chunk;
+        len -= chunk;
+        platform.audio.bufferRemaining -= chunk;
     }
 }
 
 static void initSound()
 {
-    platform.audio.mutex = SDL_CreateMutex();
+    const struct StudioOptions* options = &studio_config(platform.studio)->options;
 
     SDL_AudioSpec want =
     {
-        .freq = TIC80_SAMPLERATE,
+        .freq = options->samplerate > 0 ? options->samplerate : TIC80_SAMPLERATE,
         .format = AUDIO_S16,
         .channels = TIC80_SAMPLE_CHANNELS,
         .userdata = NULL,
         .callback = audioCallback,
-        .samples = 1024,
+        .samples = options->audioBuffer > 0 ? options->audioBuffer : AUDIO_BUFFER_SIZE,
     };
 
-    if (studio_config(platform.studio)->fft)
+    const StudioConfig* config = studio_config(platform.studio);
+    if (config->fft)
     {
-        FFT_Open(studio_config(platform.studio)->fftcaptureplaybackdevices, studio_config(platform.studio)->fftdevice);
+        FFT_Settings fft = {config->fftsize, config->ffthop, config->fftwindow};
+        FFT_Open(config->fftcaptureplaybackdevices, config->fftdevice, &fft);
     }
 
-    platform.audio.device = SDL_OpenAudioDevice(NULL, 0, &want, &platform.audio.spec, 0);
+    // with no rate set take whatever the device runs at (usually 48kHz) so it doesn't resample,
+    // the core is switched to the obtained rate before the device is unpaused
+    platform.audio.device = SDL_OpenAudioDevice(NULL, 0, &want, &platform.audio.spec,
+        options->samplerate > 0 ? 0 : SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+
+    if(platform.audio.device)
+        studio_audiospec(platform.studio, platform.audio.spec.freq, platform.audio.spec.samples);
 }
 
 static const u8* getSpritePtr(const tic_tile* tiles, s32 x, s32 y)
@@ -389,6 +411,48 @@ static void updateTextureBytes(Texture texture, const void* data, s32 width, s32
     }
 }
 
+static void updateTextureRows(Texture texture, const u32* data, s32 width, s32 first, s32 count)
+{
+#if defined(CRT_SHADER_SUPPORT)
+    if(!studio_config(platform.studio)->soft)
+    {
+        GPU_Rect rect = {0, first, width, count};
+        GPU_UpdateImageBytes(texture.gpu, &rect, (const u8*)(data + first * width), width * sizeof(u32));
+    }
+    else
+#endif
+    {
+        void* pixels = NULL;
+        s32 pitch = 0;
+        SDL_Rect rect = {0, first, width, count};
+        SDL_LockTexture(texture.sdl, &rect, &pixels, &pitch);
+
+        for(s32 i = 0; i < count; i++)
+            SDL_memcpy((u8*)pixels + i * pitch, data + (first + i) * width, width * sizeof(u32));
+
+        SDL_UnlockTexture(texture.sdl);
+    }
+}
+
+// uploads only the band of rows changed by the last blit
+static void updateScreenTexture(const tic_mem* tic)
+{
+    if(platform.screen.invalid)
+    {
+        platform.screen.invalid = false;
+        updateTextureBytes(platform.screen.texture, tic->product.screen, TIC80_FULLWIDTH, TIC80_FULLHEIGHT);
+        return;
+    }
+
+    s32 first = 0, last = TIC80_FULLHEIGHT;
+
+    while(first < last && !TIC80_ROW_DIRTY(&tic->product, first)) first++;
+    while(last > first && !TIC80_ROW_DIRTY(&tic->product, last - 1)) last--;
+
+    if(first < last)
+        updateTextureRows(platform.screen.texture, tic->product.screen, TIC80_FULLWIDTH, first, last - first);
+}
+
 #if defined(TOUCH_INPUT_SUPPORT)
 
 static void drawKeyboardLabels(tic_mem* tic, s32 shift)
@@ -588,6 +652,8 @@ static void initGPU()
             SDL_TEXTUREACCESS_STREAMING, TIC80_FULLWIDTH, TIC80_FULLHEIGHT);
     }
 
+    platform.screen.invalid = true;
+
 #if defined(TOUCH_INPUT_SUPPORT)
     initTouchGamepad();
     initTouchKeyboard();
@@ -1239,6 +1305,10 @@ static void pollEvents()
         case SDL_DROPFILE:
             studio_load(platform.studio, event.drop.file);
             break;
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            platform.screen.invalid = true;
+            break;
         case SDL_QUIT:
             studio_exit(platform.studio);
             break;
@@ -1767,13 +1837,10 @@ static void gpuTick()
         return;
     }
 
-    LOCK_MUTEX(platform.audio.mutex)
-    {
-        studio_tick(platform.studio, platform.input);
-    }
+    studio_tick(platform.studio, platform.input);
 
     renderClear(platform.screen.renderer);
-    updateTextureBytes(platform.screen.texture, tic->product.screen, TIC80_FULLWIDTH, TIC80_FULLHEIGHT);
+    updateScreenTexture(tic);
 
     SDL_Rect rect;
     calcTextureRect(&rect);
@@ -1998,6 +2065,14 @@ static s32 start(s32 argc, char **argv, const char* folder)
 
                 while (!studio_alive(platform.studio))
                 {
+                    // sleep until something happens when the editors have nothing to draw,
+                    // every wakeup still ticks the studio so remoting commands get through
+                    if(studio_idle(platform.studio))
+                    {
+                        SDL_WaitEventTimeout(NULL, IDLE_TIMEOUT);
+                        nextTick = SDL_GetPerformanceCounter();
+                    }
+
                     gpuTick();
 
                     s64 delay = (nextTick += Delta) - SDL_GetPerformanceCounter();
@@ -2037,8 +2112,6 @@ static s32 start(s32 argc, char **argv, const char* folder)
                     FFT_Close();
                 }
             }
-
-            SDL_DestroyMutex(platform.audio.mutex);
         }
     }
 
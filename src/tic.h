@@ -101,6 +101,10 @@
 #define TIC_CODE_SIZE (TIC_BANK_SIZE * TIC_BANKS)
 #define TIC_BINARY_BANKS 4
 #define TIC_BINARY_SIZE (TIC_BINARY_BANKS * TIC_BANK_SIZE) // 4 * 64k = 256K
+#define TIC_STREAM_RATE 8000
+#define TIC_STREAM_MAXRATE 96000
+#define TIC_AUDIOTAP_SIZE 4096 // output samples kept per voice, a power of two
+#define TIC_AUDIOTAP_CHANNELS (TIC_SOUND_CHANNELS + 2) // sound channels, pcm and stream
 
 
 #define TIC_BUTTONS 8
@@ -0,0 +1,160 @@
+#include "carthash.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// XXH64, so the build tool can compute the same values with any xxHash library.
+#define PRIME1 0x9E3779B185EBCA87ULL
+#define PRIME2 0xC2B2AE3D27D4EB4FULL
+#define PRIME3 0x165667B19E3779F9ULL
+#define PRIME4 0x85EBCA77C2B2AE63ULL
+#define PRIME5 0x27D4EB2F165667C5ULL
+
+static inline u64 rotl(u64 x, s32 r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline u64 read64(const u8* ptr)
+{
+    u64 value;
+    memcpy(&value, ptr, sizeof value);
+    return value;
+}
+
+static inline u32 read32(const u8* ptr)
+{
+    u32 value;
+    memcpy(&value, ptr, sizeof value);
+    return value;
+}
+
+static inline u64 round64(u64 acc, u64 input)
+{
+    return rotl(acc + input * PRIME2, 31) * PRIME1;
+}
+
+static inline u64 merge64(u64 acc, u64 value)
+{
+    return (acc ^ round64(0, value)) * PRIME1 + PRIME4;
+}
+
+u64 tb_xxh64(const void* data, size_t size, u64 seed)
+{
+    const u8* ptr = data;
+    const u8* end = ptr + size;
+    u64 hash;
+
+    if(size >= 32)
+    {
+        u64 v1 = seed + PRIME1 + PRIME2;
+        u64 v2 = seed + PRIME2;
+        u64 v3 = seed;
+        u64 v4 = seed - PRIME1;
+
+        for(const u8* limit = end - 32; ptr <= limit; ptr += 32)
+        {
+            v1 = round64(v1, read64(ptr));
+            v2 = round64(v2, read64(ptr + 8));
+            v3 = round64(v3, read64(ptr + 16));
+            v4 = round64(v4, read64(ptr + 24));
+        }
+
+        hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        hash = merge64(hash, v1);
+        hash = merge64(hash, v2);
+        hash = merge64(hash, v3);
+        hash = merge64(hash, v4);
+    }
+    else hash = seed + PRIME5;
+
+    hash += size;
+
+    for(; ptr + 8 <= end; ptr += 8)
+        hash = rotl(hash ^ round64(0, read64(ptr)), 27) * PRIME1 + PRIME4;
+
+    if(ptr + 4 <= end)
+    {
+        hash = rotl(hash ^ read32(ptr) * PRIME1, 23) * PRIME2 + PRIME3;
+        ptr += 4;
+    }
+
+    while(ptr < end)
+        hash = rotl(hash ^ *ptr++ * PRIME5, 11) * PRIME1;
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+static const struct
+{
+    const char* name;
+    u32 offset;
+    u32 size;
+} Sections[] =
+{
+#define TB_SECTION_DEF(NAME, _, INDEX) {#NAME, offsetof(tic_bank, NAME), sizeof(((tic_bank*)0)->NAME)},
+    TIC_SYNC_LIST(TB_SECTION_DEF)
+#undef TB_SECTION_DEF
+};
+
+void tb_carthash_invalidate(tb_carthash* cache, u32 mask)
+{
+    cache->valid &= ~mask;
+}
+
+static void update(tb_carthash* cache, const tic_cartridge* cart)
+{
+    u32 dirty = ~cache->valid & tb_hash_all;
+
+    if(dirty & tb_hash_code)
+    {
+        // the code is a string, the tail of the buffer isn't part of it
+        const char* nul = memchr(cart->code.data, '\0', sizeof cart->code.data);
+        cache->code = tb_xxh64(cart->code.data, nul ? nul - cart->code.data : sizeof cart->code.data, 0);
+    }
+
+    if(dirty & tb_hash_binary)
+        cache->binary = tb_xxh64(cart->binary.data, MIN(cart->binary.size, sizeof cart->binary.data), 0);
+
+    for(s32 i = 0; i < COUNT_OF(Sections); i++)
+        if(dirty & (1 << i))
+            for(s32 b = 0; b < TIC_BANKS; b++)
+                cache->bank[b][i] = tb_xxh64((const u8*)&cart->banks[b] + Sections[i].offset, Sections[i].size, 0);
+
+    cache->valid = tb_hash_all;
+}
+
+bool tb_carthash_list(tb_carthash* cache, const tic_cartridge* cart, char* out, size_t outcap, char* err, size_t errcap)
+{
+    if(!out || outcap == 0)
+    {
+        if(err && errcap) { strncpy(err, "missing output buffer", errcap - 1); err[errcap - 1] = '\0'; }
+        return false;
+    }
+
+    update(cache, cart);
+
+    s32 len = snprintf(out, outcap, "code=%016llx,binary=%016llx",
+        (unsigned long long)cache->code, (unsigned long long)cache->binary);
+
+    for(s32 b = 0; b < TIC_BANKS; b++)
+        for(s32 i = 0; i < COUNT_OF(Sections); i++)
+            if(len >= 0 && len < outcap)
+                len += snprintf(out + len, outcap - len, ",bank%i.%s=%016llx",
+                    b, Sections[i].name, (unsigned long long)cache->bank[b][i]);
+
+    if(len < 0 || len >= outcap)
+    {
+        out[0] = '\0';
+        if(err && errcap) { strncpy(err, "output too long", errcap - 1); err[errcap - 1] = '\0'; }
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "api.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Section bits for invalidation; bank sections reuse the tic_sync_* masks.
+enum
+{
+    tb_hash_code    = 1 << 8,
+    tb_hash_binary  = 1 << 9,
+    tb_hash_all     = (1 << 10) - 1,
+};
+
+// Per-section XXH64 hashes of a cartridge, recomputed only for invalidated sections.
+typedef struct
+{
+    u64 bank[TIC_BANKS][8];
+    u64 code;
+    u64 binary;
+    u32 valid;
+} tb_carthash;
+
+u64 tb_xxh64(const void* data, size_t size, u64 seed);
+
+void tb_carthash_invalidate(tb_carthash* cache, u32 mask);
+
+// Writes `name=hash` pairs separated by commas, e.g. `code=...,binary=...,bank0.tiles=...`.
+bool tb_carthash_list(tb_carthash* cache, const tic_cartridge* cart, char* out, size_t outcap, char* err, size_t errcap);
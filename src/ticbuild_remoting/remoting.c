@@ -18,7 +18,7 @@ TicbuildRemoting* ticbuild_remoting_create(int port, const ticbuild_remoting_cal
 }
 
 void ticbuild_remoting_close(TicbuildRemoting* ctx) { (void)ctx; }
-void ticbuild_remoting_tick(TicbuildRemoting* ctx) { (void)ctx; }
+bool ticbuild_remoting_tick(TicbuildRemoting* ctx) { (void)ctx; return false; }
 
 void ticbuild_remoting_on_frame(TicbuildRemoting* ctx, uint64_t counter, uint64_t freq) { (void)ctx; (void)counter; (void)freq; }
 int ticbuild_remoting_get_fps(const TicbuildRemoting* ctx) { (void)ctx; return 0; }
@@ -26,6 +26,7 @@ void ticbuild_remoting_set_user_time_ms10(TicbuildRemoting* ctx, uint32_t tic_ms
 {
     (void)ctx; (void)tic_ms10; (void)scn_ms10; (void)bdr_ms10; (void)total_ms10;
 }
+void ticbuild_remoting_set_audio_latency_ms10(TicbuildRemoting* ctx, uint32_t ms10) { (void)ctx; (void)ms10; }
 void ticbuild_remoting_get_title_info(const TicbuildRemoting* ctx, char* out, size_t outcap) { (void)ctx; if(out && outcap) out[0] = '\0'; }
 bool ticbuild_remoting_take_title_dirty(TicbuildRemoting* ctx) { (void)ctx; return false; }
 
@@ -51,6 +52,7 @@ enum { TB_INBUF_LIMIT = 1024 * 1024 /* 1 MB */ };
 enum { TB_OUTBUF_LIMIT = 1024 * 1024 };
 enum { TB_LINE_LIMIT = 1024 * 1024 };
 enum { TB_PEEK_LIMIT = 1024 * 1024 };
+enum { TB_AUDIOTAP_LIMIT = 2048 };
 enum { TB_MAX_CLIENTS = 10 };
 
 typedef struct
@@ -112,6 +114,9 @@ struct TicbuildRemoting
     uint32_t user_bdr_ms10;
     uint32_t user_total_ms10;
 
+    // Audio latency (0.1ms fixed units)
+    uint32_t audio_latency_ms10;
+
     bool wsa_started;
 
     tb_socket listen_sock;
@@ -164,6 +169,17 @@ void ticbuild_remoting_set_user_time_ms10(TicbuildRemoting* ctx, uint32_t tic_ms
     }
 }
 
+void ticbuild_remoting_set_audio_latency_ms10(TicbuildRemoting* ctx, uint32_t ms10)
+{
+    if(!ctx) return;
+
+    // the queue depth jitters by a fraction of a tick, only refresh the title on whole ms
+    if(ctx->audio_latency_ms10 / 10 != ms10 / 10)
+        tb_mark_title_dirty(ctx);
+
+    ctx->audio_latency_ms10 = ms10;
+}
+
 void ticbuild_remoting_get_title_info(const TicbuildRemoting* ctx, char* out, size_t outcap)
 {
     if(!out || outcap == 0) return;
@@ -188,16 +204,17 @@ void ticbuild_remoting_get_title_info(const TicbuildRemoting* ctx, char* out, si
         listen_state = "remoting not listening";
     }
 
-    char ticbuf[32], scnbuf[32], bdrbuf[32], totbuf[32];
+    char ticbuf[32], scnbuf[32], bdrbuf[32], totbuf[32], audbuf[32];
     tb_format_ms10(ticbuf, sizeof ticbuf, ctx->user_tic_ms10);
     tb_format_ms10(scnbuf, sizeof scnbuf, ctx->user_scn_ms10);
     tb_format_ms10(bdrbuf, sizeof bdrbuf, ctx->user_bdr_ms10);
     tb_format_ms10(totbuf, sizeof totbuf, ctx->user_total_ms10);
+    tb_format_ms10(audbuf, sizeof audbuf, ctx->audio_latency_ms10 / 10 * 10);
 
     snprintf(out, outcap,
-        "FPS: %d | TIC %s SCN %s BDR %s TOT %s | %s",
+        "FPS: %d | TIC %s SCN %s BDR %s TOT %s | AUD %s | %s",
         tb_fps_get(&ctx->fps),
-        ticbuf, scnbuf, bdrbuf, totbuf,
+        ticbuf, scnbuf, bdrbuf, totbuf, audbuf,
         listen_state);
 }
 
@@ -1198,6 +1215,68 @@ static void tb_handle_line(TicbuildRemoting* ctx, tb_client* client, const char*
         return;
     }
 
+    if(strcmp(cmd, "getaudiolatency") == 0)
+    {
+        if(argc != 0)
+        {
+            tb_free_args(args, argc);
+            tb_send_response_str(client, id, false, "usage: <id> getaudiolatency");
+            return;
+        }
+
+        char data[32];
+        snprintf(data, sizeof data, "%u", (unsigned)ctx->audio_latency_ms10 * 100);
+        tb_free_args(args, argc);
+        tb_send_response_str(client, id, true, data);
+        return;
+    }
+
+    if(strcmp(cmd, "audiotap") == 0)
+    {
+        if(argc != 2 || args[0].type != TB_ARG_INT || args[1].type != TB_ARG_INT)
+        {
+            tb_free_args(args, argc);
+            tb_send_response_str(client, id, false, "usage: <id> audiotap <channel> <count>");
+            return;
+        }
+
+        if(!ctx->cb.audiotap)
+        {
+            tb_free_args(args, argc);
+            tb_send_response_str(client, id, false, "audiotap not supported");
+            return;
+        }
+
+        uint32_t count = (uint32_t)args[1].v.i;
+        if(count == 0 || count > TB_AUDIOTAP_LIMIT)
+        {
+            tb_free_args(args, argc);
+            tb_send_response_str(client, id, false, "invalid count");
+            return;
+        }
+
+        int16_t samples[TB_AUDIOTAP_LIMIT];
+        bool ok = ctx->cb.audiotap(ctx->cb.userdata, (uint32_t)args[0].v.i, count, samples, err, sizeof err);
+        tb_free_args(args, argc);
+
+        if(!ok)
+        {
+            tb_send_response_str(client, id, false, err);
+            return;
+        }
+
+        // 16-bit little endian, oldest sample first
+        uint8_t bytes[TB_AUDIOTAP_LIMIT * 2];
+        for(uint32_t i = 0; i < count; i++)
+        {
+            bytes[i * 2] = (uint8_t)((uint16_t)samples[i] & 0xff);
+            bytes[i * 2 + 1] = (uint8_t)((uint16_t)samples[i] >> 8);
+        }
+
+        tb_send_response_bytes(client, id, bytes, count * 2);
+        return;
+    }
+
     if(strcmp(cmd, "cartpath") == 0)
     {
         if(argc != 0)
@@ -1363,17 +1442,41 @@ static void tb_handle_line(TicbuildRemoting* ctx, tb_client* client, const char*
         return;
     }
 
+    if(strcmp(cmd, "hashes") == 0)
+    {
+        if(argc != 0)
+        {
+            tb_free_args(args, argc);
+            tb_send_response_str(client, id, false, "usage: <id> hashes");
+            return;
+        }
+
+        if(!ctx->cb.hashes)
+        {
+            tb_free_args(args, argc);
+            tb_send_response_str(client, id, false, "hashes not supported");
+            return;
+        }
+
+        char out[4096];
+        out[0] = '\0';
+        bool ok = ctx->cb.hashes(ctx->cb.userdata, out, sizeof out, err, sizeof err);
+        tb_free_args(args, argc);
+        tb_send_response_str(client, id, ok, ok ? out : err);
+        return;
+    }
+
     tb_free_args(args, argc);
     tb_send_response_str(client, id, false, "unknown command");
 }
 
-// pushes complete lines out of inbuf to handler.
-static void tb_process_input(TicbuildRemoting* ctx, int index)
+// pushes complete lines out of inbuf to handler, true if there were any.
+static bool tb_process_input(TicbuildRemoting* ctx, int index)
 {
-    if(index < 0 || index >= TB_MAX_CLIENTS) return;
+    if(index < 0 || index >= TB_MAX_CLIENTS) return false;
 
     tb_client* client = &ctx->clients[index];
-    if(client->inlen == 0) return;
+    if(client->inlen == 0) return false;
 
     // process in complete lines
     size_t start = 0;
@@ -1398,6 +1501,8 @@ static void tb_process_input(TicbuildRemoting* ctx, int index)
         memmove(client->inbuf, client->inbuf + start, client->inlen - start);
         client->inlen -= start;
     }
+
+    return start > 0;
 }
 
 TicbuildRemoting* ticbuild_remoting_create(int port, const ticbuild_remoting_callbacks* callbacks)
@@ -1457,9 +1562,9 @@ void ticbuild_remoting_close(TicbuildRemoting* ctx)
     free(ctx);
 }
 
-void ticbuild_remoting_tick(TicbuildRemoting* ctx)
+bool ticbuild_remoting_tick(TicbuildRemoting* ctx)
 {
-    if(!ctx) return;
+    if(!ctx) return false;
 
     char err[128];
     if(!tb_socket_init(ctx, err, sizeof err))
@@ -1467,7 +1572,7 @@ void ticbuild_remoting_tick(TicbuildRemoting* ctx)
         tb_discovery_stop();
         tb_set_err(ctx->last_listen_err, sizeof ctx->last_listen_err, err[0] ? err : "socket init failed");
         tb_mark_title_dirty(ctx);
-        return;
+        return false;
     }
 
     // Clear previous error once we're healthy.
@@ -1479,11 +1584,13 @@ void ticbuild_remoting_tick(TicbuildRemoting* ctx)
 
     tb_accept_client(ctx);
 
+    bool handled = false;
+
     for(int i = 0; i < TB_MAX_CLIENTS; i++)
     {
         if(ctx->clients[i].sock == TB_INVALID_SOCKET) continue;
         tb_read_client(ctx, i);
-        tb_process_input(ctx, i);
+        handled |= tb_process_input(ctx, i);
         tb_flush_output(ctx, i);
     }
 
@@ -1493,6 +1600,8 @@ void ticbuild_remoting_tick(TicbuildRemoting* ctx)
         ctx->last_client_count = ctx->client_count;
         tb_mark_title_dirty(ctx);
     }
+
+    return handled;
 }
 
 #endif // __EMSCRIPTEN__
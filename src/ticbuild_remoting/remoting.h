@@ -23,6 +23,7 @@ typedef struct
     bool (*sync)(void* userdata, uint32_t flags, char* err, size_t errcap);
     bool (*poke)(void* userdata, uint32_t addr, const uint8_t* data, size_t size, char* err, size_t errcap);
     bool (*peek)(void* userdata, uint32_t addr, uint32_t size, uint8_t* out, char* err, size_t errcap);
+    bool (*audiotap)(void* userdata, uint32_t channel, uint32_t count, int16_t* out, char* err, size_t errcap);
 
     bool (*eval)(void* userdata, const char* code, char* err, size_t errcap);
     bool (*eval_expr)(void* userdata, const char* expr, char* out, size_t outcap, char* err, size_t errcap);
@@ -30,12 +31,14 @@ typedef struct
     bool (*cart_path)(void* userdata, char* out, size_t outcap, char* err, size_t errcap);
     bool (*fs_path)(void* userdata, char* out, size_t outcap, char* err, size_t errcap);
     bool (*metadata)(void* userdata, const char* key, char* out, size_t outcap, char* err, size_t errcap);
+    bool (*hashes)(void* userdata, char* out, size_t outcap, char* err, size_t errcap);
 } ticbuild_remoting_callbacks;
 
 TicbuildRemoting* ticbuild_remoting_create(int port, const ticbuild_remoting_callbacks* callbacks);
 void ticbuild_remoting_close(TicbuildRemoting* ctx);
 
-void ticbuild_remoting_tick(TicbuildRemoting* ctx);
+// Pumps the socket, returns true if any command was handled.
+bool ticbuild_remoting_tick(TicbuildRemoting* ctx);
 
 // Per-frame timing hook (call once per rendered frame).
 // `counter`/`freq` should come from tic_sys_counter_get()/tic_sys_freq_get().
@@ -47,6 +50,9 @@ int ticbuild_remoting_get_fps(const TicbuildRemoting* ctx);
 // per-frame time spent in user callbacks, in 0.1ms units.
 void ticbuild_remoting_set_user_time_ms10(TicbuildRemoting* ctx, uint32_t tic_ms10, uint32_t scn_ms10, uint32_t bdr_ms10, uint32_t total_ms10);
 
+// measured audio latency (sound queue + device buffer), in 0.1ms units.
+void ticbuild_remoting_set_audio_latency_ms10(TicbuildRemoting* ctx, uint32_t ms10);
+
 // Builds a short status string suitable for the window title, e.g.
 // `FPS: 60 | listening on 127.0.0.1:9977`.
 void ticbuild_remoting_get_title_info(const TicbuildRemoting* ctx, char* out, size_t outcap);
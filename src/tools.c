@@ -130,7 +130,8 @@ tic_blitpal tic_tool_palette_blit(const tic_palette* srcpal, tic80_pixel_color_f
 
 bool tic_tool_has_ext(const char* name, const char* ext)
 {
-    return strcmp(name + strlen(name) - strlen(ext), ext) == 0;
+    size_t len = strlen(name), extlen = strlen(ext);
+    return len >= extlen && strcmp(name + len - extlen, ext) == 0;
 }
 
 s32 tic_tool_get_track_row_sfx(const tic_track_row* row)
@@ -171,38 +172,49 @@ bool tic_tool_noise(const tic_waveform* wave)
     return FLAT4(wave->data) && *wave->data % 0xff == 0;
 }
 
+#define HEX_ROW(hi) hi"0" hi"1" hi"2" hi"3" hi"4" hi"5" hi"6" hi"7" hi"8" hi"9" hi"a" hi"b" hi"c" hi"d" hi"e" hi"f"
+
+// two hex digits for every byte value
+static const char HexPairs[] =
+    HEX_ROW("0") HEX_ROW("1") HEX_ROW("2") HEX_ROW("3") HEX_ROW("4") HEX_ROW("5") HEX_ROW("6") HEX_ROW("7")
+    HEX_ROW("8") HEX_ROW("9") HEX_ROW("a") HEX_ROW("b") HEX_ROW("c") HEX_ROW("d") HEX_ROW("e") HEX_ROW("f");
+
+#undef HEX_ROW
+
 void tic_tool_buf2str(const void* data, s32 size, char* str, bool flip)
 {
-    for(s32 i = 0; i < size; i++, str += 2)
+    for(const u8 *ptr = data, *end = ptr + size; ptr != end; ptr++, str += 2)
     {
-        sprintf(str, "%02x", ((u8*)data)[i]);
-        if(flip) SWAP(str[0], str[1], char);
+        u8 value = flip ? (u8)(*ptr << 4 | *ptr >> 4) : *ptr;
+        memcpy(str, HexPairs + value * 2, 2);
     }
+
+    *str = '\0';
 }
 
+// hex digit values plus one, zero marks the other chars
+static const u8 HexDigits[256] =
+{
+    ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+    ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+};
+
 void tic_tool_str2buf(const char* str, s32 size, void* buf, bool flip)
 {
-    char val[] = "0x00";
-    const char* ptr = str;
+    const u8* ptr = (const u8*)str;
 
-    for(s32 i = 0; i < size/2; i++)
+    for(s32 i = 0; i < size/2; i++, ptr += 2)
     {
-        if(flip)
-        {
-            val[3] = *ptr++;
-            val[2] = *ptr++;
-        }
-        else
-        {
-            val[2] = *ptr++;
-            val[3] = *ptr++;
-        }
+        // a bad digit ends the number like in strtol, "x5" reads as 0 and "5x" as 5
+        u8 hi = HexDigits[ptr[flip]];
+        u8 lo = hi ? HexDigits[ptr[!flip]] : 0;
 
-        ((u8*)buf)[i] = (u8)strtol(val, NULL, 16);
+        ((u8*)buf)[i] = hi ? lo ? (hi - 1) << 4 | (lo - 1) : hi - 1 : 0;
     }
 }
 
-const char* tic_tool_metatag(const char* code, const char* tag, const char* comment)
+char* tic_tool_metatag_copy(const char* code, const char* tag, const char* comment, char* value, s32 size)
 {
     const char* start = NULL;
 
@@ -218,7 +230,6 @@ const char* tic_tool_metatag(const char* code, const char* tag, const char* comm
             start += strlen(tagBuffer);
     }
 
-    static char value[128];
     *value = '\0';
 
     if (start)
@@ -230,12 +241,18 @@ const char* tic_tool_metatag(const char* code, const char* tag, const char* comm
             while (isspace(*start) && start < end) start++;
             while (isspace(*(end - 1)) && end > start) end--;
 
-            const s32 size = MIN((s32)(end - start), sizeof value - 1);
+            const s32 length = MIN((s32)(end - start), size - 1);
 
-            memcpy(value, start, size);
-            value[size] = '\0';
+            memcpy(value, start, length);
+            value[length] = '\0';
         }
     }
 
     return value;
+}
+
+const char* tic_tool_metatag(const char* code, const char* tag, const char* comment)
+{
+    static char value[128];
+    return tic_tool_metatag_copy(code, tag, comment, value, sizeof value);
 }
\ No newline at end of file
@@ -111,3 +111,5 @@ bool    tic_tool_noise(const tic_waveform* wave);
 u32     tic_nearest_color(const tic_rgb* palette, const tic_rgb* color, s32 count);
 
 const char* tic_tool_metatag(const char* code, const char* tag, const char* comment);
+// same as above but writes to the caller's buffer, safe to use off the main thread
+char*   tic_tool_metatag_copy(const char* code, const char* tag, const char* comment, char* value, s32 size);